@@ -0,0 +1,401 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cxxspec.hpp"
+#include "formatters/cli_formatter.hpp"
+#include "formatters/json_formatter.hpp"
+#include "formatters/junit_formatter.hpp"
+#include "../tools/synthetic.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace cxxspec {
+namespace bench {
+
+    volatile std::size_t hookCalls = 0;
+
+    // swallows everything a formatter writes
+    class NullBuffer : public std::streambuf {
+    protected:
+        int overflow(int c) override {
+            return c;
+        }
+
+        std::streamsize xsputn(const char*, std::streamsize count) override {
+            return count;
+        }
+    };
+
+    // reports nothing, so running with it measures the execution alone
+    class NullFormatter : public Formatter {
+    public:
+        void onBeginTesting() {}
+        void onEndTesting() {}
+        void onEnterSpec(Spec& spec) {}
+        void onLeaveSpec(Spec& spec, bool hasNextElement) {}
+        void onEnterExample(Example& example) {}
+        void onExampleResult(Example& example, bool result, std::string reason, ExampleDuration timeTaken) {}
+        void onLeaveExample(Example& example, bool hasNextElement) {}
+    };
+
+    struct Options {
+        std::vector<std::size_t> sizes = { 1000, 10000, 100000 };
+        unsigned depth = 2;
+        unsigned fanout = 4;
+        unsigned hooks = 1;
+        unsigned expects = 1;
+        unsigned repeat = 3;
+        std::string output = "-";
+    };
+
+    struct Result {
+        std::string name;
+        TreeShape shape;
+        double seconds;
+        // what `perUnit` is measured per
+        std::string unit;
+        std::size_t units;
+    };
+
+    typedef std::chrono::steady_clock Clock;
+
+    static double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    /**
+     * Best time out of `repeat` runs of `measure`, which builds a fresh tree for every run and returns the time of the part it measures
+     */
+    static double best(unsigned repeat, const std::function<double()>& measure) {
+        double result = measure();
+        for (unsigned i = 1; i < repeat; i++) {
+            result = std::min(result, measure());
+        }
+        return result;
+    }
+
+    static double timeRun(const TreeShape& shape, const std::function<Formatter*(std::ostream&)>& makeFormatter) {
+        NullBuffer buffer;
+        std::ostream stream(&buffer);
+        std::unique_ptr<Formatter> formatter(makeFormatter(stream));
+
+        std::vector<Spec> specs = buildTree(shape);
+        for (Spec& spec : specs) {
+            spec.selectExamples([] (const Example&) { return true; });
+        }
+
+        Clock::time_point start = Clock::now();
+        formatter->onBeginTesting();
+        for (std::size_t i = 0; i < specs.size(); i++) {
+            specs[i].run(*formatter, i + 1 < specs.size());
+        }
+        formatter->onEndTesting();
+        return secondsSince(start);
+    }
+
+    static std::size_t countSpecs(const TreeShape& shape) {
+        std::size_t count = 0, level = shape.describes;
+        for (unsigned i = 0; i <= shape.depth; i++) {
+            count += level;
+            level *= shape.fanout;
+        }
+        return count;
+    }
+
+    static void measure(const Options& options, std::size_t size, std::vector<Result>& results) {
+        TreeShape shape;
+        shape.examples = size;
+        shape.describes = std::max<std::size_t>(1, size / 1000);
+        shape.depth = options.depth;
+        shape.fanout = options.fanout;
+        shape.hooks = options.hooks;
+        shape.expects = options.expects;
+
+        // creating the top-level specs, which is what loading the specs of all `describe`s amounts to
+        double startup = best(options.repeat, [&shape] () {
+            Clock::time_point start = Clock::now();
+            std::vector<Spec> specs = buildTree(shape);
+            return secondsSince(start);
+        });
+        results.push_back(Result{ "startup", shape, startup, "describe", shape.describes });
+
+        double definition = best(options.repeat, [&shape] () {
+            std::vector<Spec> specs = buildTree(shape);
+            Clock::time_point start = Clock::now();
+            for (Spec& spec : specs) {
+                spec.selectExamples([] (const Example&) { return true; });
+            }
+            return secondsSince(start);
+        });
+        results.push_back(Result{ "definition", shape, definition, "example", shape.examples });
+
+        auto null = [] (std::ostream&) -> Formatter* { return new NullFormatter(); };
+        double execution = best(options.repeat, [&shape, &null] () { return timeRun(shape, null); });
+        results.push_back(Result{ "execution", shape, execution, "example", shape.examples });
+
+        // the costs of hooks & expectations are the differences to the same tree without them
+        TreeShape bare = shape;
+        bare.hooks = 0;
+        bare.expects = 0;
+        double bareExecution = best(options.repeat, [&bare, &null] () { return timeRun(bare, null); });
+        results.push_back(Result{ "execution_bare", bare, bareExecution, "example", bare.examples });
+
+        if (shape.hooks > 0) {
+            TreeShape hooked = bare;
+            hooked.hooks = shape.hooks;
+            double hookTime = best(options.repeat, [&hooked, &null] () { return timeRun(hooked, null); });
+            // every level of contexts contributes it's before_each & after_each hooks
+            std::size_t calls = shape.examples * 2 * shape.hooks * (shape.depth + 1);
+            results.push_back(Result{ "hook", hooked, std::max(0.0, hookTime - bareExecution), "hook call", calls });
+        }
+        if (shape.expects > 0) {
+            TreeShape expecting = bare;
+            expecting.expects = shape.expects;
+            double expectTime = best(options.repeat, [&expecting, &null] () { return timeRun(expecting, null); });
+            results.push_back(Result{ "expect", expecting, std::max(0.0, expectTime - bareExecution), "expect", shape.examples * shape.expects });
+        }
+
+        // every example fails it's single expectation; thrown & caught, or recorded with CXXSPEC_FAILURE_RECORDS
+        TreeShape failing = bare;
+        failing.expects = 1;
+        failing.failEvery = 1;
+        double failTime = best(options.repeat, [&failing, &null] () { return timeRun(failing, null); });
+        results.push_back(Result{ "expect_fail", failing, std::max(0.0, failTime - bareExecution), "failed expect", shape.examples });
+
+        // formatter overhead on top of the execution; every spec causes 2 events, every example 3
+        std::size_t events = 2 * countSpecs(shape) + 3 * shape.examples;
+        std::vector<std::pair<std::string, std::function<Formatter*(std::ostream&)>>> formatters = {
+            { "formatter_cli", [] (std::ostream& stream) -> Formatter* { return new CliFormatter(stream, false); } },
+            { "formatter_json", [] (std::ostream& stream) -> Formatter* { return new JsonFormatter(stream, true); } },
+            { "formatter_junit", [] (std::ostream& stream) -> Formatter* { return new JunitFormatter(stream, true); } },
+        };
+        for (auto& formatter : formatters) {
+            double time = best(options.repeat, [&shape, &formatter] () { return timeRun(shape, formatter.second); });
+            results.push_back(Result{ formatter.first, shape, std::max(0.0, time - execution), "event", events });
+        }
+    }
+
+    /**
+     * Cost of a single `to_match` on a log line: compiling the regex every time (as `RegexMatcher` did before
+     * patterns were cached) versus a cached regex and a literal pattern
+     */
+    static void measureRegex(const Options& options, std::vector<Result>& results) {
+        const std::size_t matches = 10000;
+        const std::string line = "2024-03-01 12:00:00.123 [worker-7] INFO connection closed by peer after 1532 ms";
+
+        // one example doing all the matches
+        TreeShape shape;
+        shape.describes = 1;
+        shape.examples = 1;
+        shape.depth = 0;
+        shape.fanout = 0;
+        shape.hooks = 0;
+        shape.expects = matches;
+
+        double uncached = best(options.repeat, [&] () {
+            Clock::time_point start = Clock::now();
+            for (std::size_t i = 0; i < matches; i++) {
+                std::regex regex("after \\d+ ms$");
+                if (!std::regex_search(line, regex)) {
+                    throw std::runtime_error("regex didn't match");
+                }
+            }
+            return secondsSince(start);
+        });
+        results.push_back(Result{ "to_match_uncached", shape, uncached, "match", matches });
+
+        std::vector<std::pair<std::string, std::string>> patterns = {
+            { "to_match_regex", "after \\d+ ms$" },
+            { "to_match_literal", "connection closed by peer" },
+        };
+        for (auto& pattern : patterns) {
+            double time = best(options.repeat, [&] () {
+                Clock::time_point start = Clock::now();
+                for (std::size_t i = 0; i < matches; i++) {
+                    Expectation<std::string>(line).to_match(pattern.second);
+                }
+                return secondsSince(start);
+            });
+            results.push_back(Result{ pattern.first, shape, time, "match", matches });
+        }
+    }
+
+    /**
+     * Cost per byte of `to_contain` looking for a substring at the end of a 4MiB payload
+     */
+    static void measureContain(const Options& options, std::vector<Result>& results) {
+        std::string payload(4 << 20, 'x');
+        for (std::size_t i = 0; i < payload.size(); i += 7) {
+            payload[i] = static_cast<char>('a' + i % 26);
+        }
+        std::string needle = "end of payload";
+        payload.replace(payload.size() - needle.size(), needle.size(), needle);
+
+        TreeShape shape;
+        shape.describes = 1;
+        shape.examples = 1;
+        shape.depth = 0;
+        shape.fanout = 0;
+        shape.hooks = 0;
+        shape.expects = 1;
+
+        double time = best(options.repeat, [&] () {
+            Clock::time_point start = Clock::now();
+            Expectation<std::string>(payload).to_contain(needle);
+            return secondsSince(start);
+        });
+        results.push_back(Result{ "to_contain_substring", shape, time, "byte", payload.size() });
+    }
+
+    static void writeResults(std::ostream& stream, const std::vector<Result>& results) {
+        stream << "{\n";
+        stream << "  \"version\": \"" << getVersion() << "\",\n";
+        #if defined(CXXSPEC_FAILURE_RECORDS)
+            stream << "  \"failures\": \"records\",\n";
+        #else
+            stream << "  \"failures\": \"exceptions\",\n";
+        #endif
+        stream << "  \"results\": [\n";
+        for (std::size_t i = 0; i < results.size(); i++) {
+            const Result& result = results[i];
+            double perUnit = result.units > 0 ? result.seconds * 1e9 / result.units : 0;
+            stream << "    {"
+                << "\"name\": \"" << result.name << "\", "
+                << "\"examples\": " << result.shape.examples << ", "
+                << "\"describes\": " << result.shape.describes << ", "
+                << "\"depth\": " << result.shape.depth << ", "
+                << "\"fanout\": " << result.shape.fanout << ", "
+                << "\"hooks\": " << result.shape.hooks << ", "
+                << "\"expects\": " << result.shape.expects << ", "
+                << "\"seconds\": " << result.seconds << ", "
+                << "\"unit\": \"" << result.unit << "\", "
+                << "\"units\": " << result.units << ", "
+                << "\"ns_per_unit\": " << perUnit
+                << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        stream << "  ]\n";
+        stream << "}\n";
+    }
+
+    static unsigned parseCount(const std::string& option, const std::string& value, bool allowZero) {
+        std::size_t end = 0;
+        unsigned long count = 0;
+        try { count = std::stoul(value, &end); } catch (std::logic_error&) {}
+        if (end != value.size() || (count == 0 && !allowZero)) {
+            throw std::runtime_error("Invalid value for " + option + ": " + value);
+        }
+        return count;
+    }
+
+    static Options parseOptions(int argc, char** argv) {
+        Options options;
+        for (int i = 0; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "-h" || arg == "--help") {
+                puts("Usage: bench [<options>]");
+                puts("Measures the overhead of cxxspec itself on synthetic spec trees; results are written as json.");
+                puts("Available options:");
+                puts("  -o <file>           Writes the results to <file> instead of the standard output");
+                puts("  --sizes <n,...>     Numbers of examples of the trees to measure (default: 1000,10000,100000)");
+                puts("  --depth <n>         Levels of contexts below every describe (default: 2)");
+                puts("  --fanout <n>        Contexts inside every context (default: 4)");
+                puts("  --hooks <n>         before_each & after_each hooks per spec (default: 1)");
+                puts("  --expects <n>       Expectations per example (default: 1)");
+                puts("  --repeat <n>        Runs every measurement <n> times and keeps the best (default: 3)");
+                exit(1);
+            }
+            if (i + 1 >= argc) {
+                throw std::runtime_error("Unknown option or missing value: " + arg);
+            }
+            std::string value = argv[++i];
+            if (arg == "-o") {
+                options.output = value;
+            }
+            else if (arg == "--sizes") {
+                options.sizes.clear();
+                std::stringstream list(value);
+                std::string size;
+                while (std::getline(list, size, ',')) {
+                    options.sizes.push_back(parseCount(arg, size, false));
+                }
+            }
+            else if (arg == "--depth") {
+                options.depth = parseCount(arg, value, true);
+            }
+            else if (arg == "--fanout") {
+                options.fanout = parseCount(arg, value, false);
+            }
+            else if (arg == "--hooks") {
+                options.hooks = parseCount(arg, value, true);
+            }
+            else if (arg == "--expects") {
+                options.expects = parseCount(arg, value, true);
+            }
+            else if (arg == "--repeat") {
+                options.repeat = parseCount(arg, value, false);
+            }
+            else {
+                throw std::runtime_error("Unknown option: " + arg);
+            }
+        }
+        return options;
+    }
+
+}
+}
+
+int main(int argc, char** argv) {
+    using namespace cxxspec::bench;
+
+    Options options;
+    try {
+        options = parseOptions(argc - 1, argv + 1);
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+
+    std::vector<Result> results;
+    for (std::size_t size : options.sizes) {
+        std::cerr << "measuring " << size << " examples..." << std::endl;
+        measure(options, size, results);
+    }
+    measureRegex(options, results);
+    measureContain(options, results);
+
+    if (options.output == "-") {
+        writeResults(std::cout, results);
+    }
+    else {
+        std::ofstream file(options.output);
+        writeResults(file, results);
+    }
+    return 0;
+}
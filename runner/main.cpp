@@ -0,0 +1,47 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cxxspec.hpp"
+
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+// shared objects given as plain arguments are spec modules; everything else is handled like in any spec binary
+static bool isModule(const std::string& arg) {
+    std::size_t pos = arg.rfind(".so");
+    if (arg.empty() || arg[0] == '-' || pos == std::string::npos || (pos + 3 != arg.size() && arg[pos + 3] != '.')) {
+        return false;
+    }
+    struct stat info;
+    return stat(arg.c_str(), &info) == 0 && S_ISREG(info.st_mode);
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; i++) {
+        std::string arg(argv[i]);
+        if (isModule(arg)) {
+            args.push_back("--module");
+        }
+        args.push_back(arg);
+    }
+    cxxspec::runSpecs(args);
+    return 0;
+}
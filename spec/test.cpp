@@ -1,4 +1,5 @@
 #include "cxxspec.hpp"
+#include "formatters/json_formatter.hpp"
 
 #include <iostream>
 #include <vector>
@@ -7,12 +8,16 @@
 #include <map>
 #include <unordered_map>
 #include <cstring>
+#include <cctype>
 #include <deque>
 #include <forward_list>
 #include <list>
 #include <array>
+#include <sstream>
 #include <thread>
 #include <chrono>
+#include <atomic>
+#include <stdexcept>
 
 DEFINE_SPEC(MyKlazz)
 
@@ -30,11 +35,109 @@ namespace mytest {
     std::array<int, 4> my_int_array({1, 2, 3, 4});
     std::forward_list<int> my_int_forward_list({1, 2, 3, 4});
     std::list<int> my_int_list({1, 2, 3, 4});
+    int my_around_depth = 0;
+    // hooks that ran after their example was abandoned
+    std::atomic<int> my_timeout_tail_runs(0);
+
+    struct MyFixture {
+        int& destroyed;
+        bool broken = false;
+
+        explicit MyFixture(int& destroyed) : destroyed(destroyed) {}
+        ~MyFixture() {
+            this->destroyed++;
+        }
+    };
+
+    int my_timeout_fixtures_destroyed = 0;
+    cxxspec::FixturePool<MyFixture> my_timeout_fixtures("timeouts", [] { return new MyFixture(my_timeout_fixtures_destroyed); }, {}, 1);
 
     #if __cplusplus >= 201703L
         std::string_view my_strview("hello world", 5);
     #endif
 
+    // skips over one json value; false if there isn't a valid one
+    bool my_skip_json(const std::string& s, size_t& pos) {
+        auto skipSpaces = [&] () {
+            while (pos < s.size() && std::isspace(static_cast<unsigned char>(s[pos]))) {
+                pos++;
+            }
+        };
+        auto next = [&] (char c) {
+            skipSpaces();
+            if (pos < s.size() && s[pos] == c) {
+                pos++;
+                return true;
+            }
+            return false;
+        };
+
+        skipSpaces();
+        if (next('{') || next('[')) {
+            char close = (s[pos - 1] == '{') ? '}' : ']';
+            if (next(close)) {
+                return true;
+            }
+            do {
+                if (close == '}') {
+                    skipSpaces();
+                    if (pos >= s.size() || s[pos] != '"' || !my_skip_json(s, pos) || !next(':')) {
+                        return false;
+                    }
+                }
+                if (!my_skip_json(s, pos)) {
+                    return false;
+                }
+            } while (next(','));
+            return next(close);
+        }
+        if (next('"')) {
+            for (; pos < s.size(); pos++) {
+                unsigned char c = s[pos];
+                if (c == '"') {
+                    pos++;
+                    return true;
+                }
+                if (c < 0x20) {
+                    return false;
+                }
+                if (c == '\\') {
+                    if (++pos >= s.size()) {
+                        return false;
+                    }
+                    if (s[pos] == 'u') {
+                        for (int n = 0; n < 4; n++) {
+                            if (++pos >= s.size() || !std::isxdigit(static_cast<unsigned char>(s[pos]))) {
+                                return false;
+                            }
+                        }
+                    }
+                    else if (std::strchr("\"\\/bfnrt", s[pos]) == nullptr) {
+                        return false;
+                    }
+                }
+            }
+            return false;
+        }
+        // numbers, true, false & null; good enough for the output of the formatters
+        size_t start = pos;
+        while (pos < s.size() && (std::isalnum(static_cast<unsigned char>(s[pos])) || std::strchr("+-.", s[pos]) != nullptr)) {
+            pos++;
+        }
+        return pos > start;
+    }
+
+    bool my_is_json(const std::string& s) {
+        size_t pos = 0;
+        if (!my_skip_json(s, pos)) {
+            return false;
+        }
+        while (pos < s.size() && std::isspace(static_cast<unsigned char>(s[pos]))) {
+            pos++;
+        }
+        return pos == s.size();
+    }
+
     class MyKlazz {
     public:
         int i;
@@ -170,6 +273,10 @@ describe(mytest, $ {
         it("should contain the letter 'x'", _ {
             expect(mytest::my_stdstr).to_contain('x');
         });
+        it("should contain \"lo wo\" but not \"world!\"", _ {
+            expect(mytest::my_stdstr).to_contain("lo wo");
+            expect(mytest::my_stdstr).to_not_contain(std::string("world!"));
+        });
         it("should match /hel+o/", _ {
             std::string re_str("hEl+o");
             expect(mytest::my_stdstr).to_match(re_str, std::regex_constants::icase);
@@ -178,6 +285,34 @@ describe(mytest, $ {
             std::string re_str("helo");
             expect(mytest::my_stdstr).to_match(re_str);
         });
+        it("should match /^hello w/ & /world$/", _ {
+            expect(mytest::my_stdstr).to_match("^hello w");
+            expect(mytest::my_stdstr).to_match("world$");
+        });
+    });
+
+    explain("substrings of long strings", $ {
+        it("should find a match crossing a block boundary", _ {
+            std::string haystack = std::string(14, 'x') + "needle" + std::string(10, 'x') + "needle" + std::string(40, 'y');
+            expect(haystack).to_contain("xneedlex");
+            expect(haystack).to_contain("xxneedleyy");
+            expect(haystack.substr(0, 40)).to_contain("needle");
+            expect(haystack + "needle").to_contain("yneedle");
+        });
+        it("should not find a missing needle", _ {
+            std::string haystack;
+            for (int i = 0; i < 20; i++) {
+                haystack += "ne_dle ";
+            }
+            expect(haystack).to_not_contain("needle");
+            expect(haystack).to_not_contain(std::string(200, 'n'));
+        });
+        it("should find needles in repetitive strings", _ {
+            std::string needle = std::string(20, 'a') + "b";
+            expect(std::string(200, 'a')).to_not_contain(needle);
+            expect(std::string(200, 'a') + "b").to_contain(needle);
+            expect(std::string(100, 'a') + "b" + std::string(100, 'a')).to_contain(needle);
+        });
     });
 
     explain("my_cstr", $ {
@@ -203,6 +338,9 @@ describe(mytest, $ {
         it("should contain the letter 'x'", _ {
             expect(mytest::my_cstr).to_contain('x');
         });
+        it("should contain \"world\"", _ {
+            expect(mytest::my_cstr).to_contain("world");
+        });
         it("should match /hel+o/", _ {
             std::string re_str("hEl+o");
             expect(mytest::my_cstr).to_match(re_str, std::regex_constants::icase);
@@ -262,6 +400,9 @@ describe(mytest, $ {
             it("should contain 'g'", _ {
                 expect(mytest::my_strview).to_contain('g');
             });
+            it("should contain \"ello\"", _ {
+                expect(mytest::my_strview).to_contain(std::string_view("ello"));
+            });
             it("should match /hel+o/", _ {
                 std::string re_str("hEl+o");
                 expect(mytest::my_strview).to_match(re_str, std::regex_constants::icase);
@@ -408,6 +549,197 @@ describe(mytest, $ {
         });
     });
 
+    // test lazy values
+
+    explain("test let", $ {
+        let(numbers, std::vector<int>{1, 2, 3})
+        subject(val(numbers).size())
+
+        it("should compute the value on first access", _ {
+            expect(val(subject)).to_eq(3u);
+        });
+        it("should memoize the value for the example", _ {
+            val(numbers).push_back(4);
+            expect(val(numbers).size()).to_eq(4u);
+        });
+        it("should start over for every example", _ {
+            expect(val(numbers).size()).to_eq(3u);
+        });
+
+        context("with let_eager", $ {
+            let(computations, 0)
+            let_eager(computation, ++val(computations))
+
+            it("should compute the value even if the example never reads it", _ {
+                expect(val(computations)).to_eq(1);
+            });
+            it("should compute the value only once per example", _ {
+                expect(val(computation)).to_eq(1);
+                expect(val(computation)).to_eq(1);
+                expect(val(computations)).to_eq(1);
+            });
+        });
+
+        context("in after_each", $ {
+            let(visits, std::vector<int>{})
+            after_each({
+                // a destroyed value would be computed anew, without the visit
+                if (visits.get(example).size() != 1) {
+                    throw std::logic_error("the value was destroyed before after_each");
+                }
+            });
+
+            it("should still be the value of the example", _ {
+                val(visits).push_back(1);
+            });
+        });
+    });
+
+    // test around hooks
+
+    explain("test around hooks", $ {
+        around_all({
+            mytest::my_around_depth++;
+            run();
+            mytest::my_around_depth--;
+        });
+        around_each({
+            mytest::my_around_depth++;
+            run();
+            mytest::my_around_depth--;
+        });
+
+        it("should run inside of all around hooks", _ {
+            expect(mytest::my_around_depth).to_eq(2);
+        });
+    });
+
+    // test fixture pools
+
+    explain("test fixture pools", $ {
+        // every example has a pool of it's own, and checks out instances for examples it finishes itself
+        it("should memoize the instance within an example", _ {
+            int created = 0, destroyed = 0;
+            {
+                cxxspec::FixturePool<mytest::MyFixture> pool("memoize", [&] { created++; return new mytest::MyFixture(destroyed); }, {}, 1);
+                cxxspec::Example ex("checkout", [] (cxxspec::Example&) {}, nullptr);
+                mytest::MyFixture* first = &pool.checkout(ex);
+                expect(&pool.checkout(ex)).to_eq(first);
+                expect(created).to_eq(1);
+                ex.finish();
+            }
+            expect(destroyed).to_eq(1);
+        });
+        it("should reset & reuse returned instances", _ {
+            int created = 0, destroyed = 0, resets = 0;
+            cxxspec::FixturePool<mytest::MyFixture> pool("reuse", [&] { created++; return new mytest::MyFixture(destroyed); }, [&] (mytest::MyFixture&) { resets++; }, 1);
+            cxxspec::Example first("first", [] (cxxspec::Example&) {}, nullptr);
+            cxxspec::Example second("second", [] (cxxspec::Example&) {}, nullptr);
+
+            mytest::MyFixture* instance = &pool.checkout(first);
+            first.finish();
+            expect(resets).to_eq(1);
+            expect(&pool.checkout(second)).to_eq(instance);
+            second.finish();
+
+            expect(created).to_eq(1);
+            expect(destroyed).to_eq(0);
+            cxxspec::FixturePoolStats stats = pool.stats();
+            expect(stats.creations).to_eq(1u);
+            expect(stats.reuses).to_eq(1u);
+            expect(stats.waits).to_eq(0u);
+            expect(stats.peak).to_eq(1u);
+        });
+        it("should prefer the instance the same thread returned", _ {
+            int created = 0, destroyed = 0;
+            cxxspec::FixturePool<mytest::MyFixture> pool("owner", [&] { created++; return new mytest::MyFixture(destroyed); }, {}, 2);
+            cxxspec::Example mine("mine", [] (cxxspec::Example&) {}, nullptr);
+            cxxspec::Example theirs("theirs", [] (cxxspec::Example&) {}, nullptr);
+            cxxspec::Example again("again", [] (cxxspec::Example&) {}, nullptr);
+
+            mytest::MyFixture* instance = &pool.checkout(mine);
+            std::thread([&] { pool.checkout(theirs); }).join();
+            mine.finish();
+            // returned after ours by another thread, so it's the last idle one
+            std::thread([&] { theirs.finish(); }).join();
+
+            expect(&pool.checkout(again)).to_eq(instance);
+            again.finish();
+            expect(created).to_eq(2);
+        });
+        it("should block at it's limit until an instance is returned", _ {
+            int created = 0, destroyed = 0;
+            cxxspec::FixturePool<mytest::MyFixture> pool("limit", [&] { created++; return new mytest::MyFixture(destroyed); }, {}, 1);
+            cxxspec::Example first("first", [] (cxxspec::Example&) {}, nullptr);
+            cxxspec::Example second("second", [] (cxxspec::Example&) {}, nullptr);
+
+            pool.checkout(first);
+            std::atomic<bool> acquired(false);
+            std::thread waiter([&] {
+                pool.checkout(second);
+                acquired = true;
+                second.finish();
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            expect(acquired.load()).to_eq(false);
+            first.finish();
+            waiter.join();
+
+            expect(acquired.load()).to_eq(true);
+            expect(created).to_eq(1);
+            cxxspec::FixturePoolStats stats = pool.stats();
+            expect(stats.waits).to_eq(1u);
+            expect(stats.peak).to_eq(1u);
+        });
+        it("should destroy an instance failing to reset", _ {
+            int created = 0, destroyed = 0;
+            cxxspec::FixturePool<mytest::MyFixture> pool("broken", [&] { created++; return new mytest::MyFixture(destroyed); },
+                [] (mytest::MyFixture& fixture) { if (fixture.broken) { throw std::runtime_error("broken fixture"); } }, 1);
+            cxxspec::Example first("first", [] (cxxspec::Example&) {}, nullptr);
+            cxxspec::Example second("second", [] (cxxspec::Example&) {}, nullptr);
+
+            pool.checkout(first).broken = true;
+            first.finish();
+            expect(destroyed).to_eq(1);
+
+            // the slot of the destroyed instance is free again
+            expect(pool.checkout(second).broken).to_eq(false);
+            second.finish();
+            expect(created).to_eq(2);
+            expect(pool.stats().reuses).to_eq(0u);
+        });
+    });
+
+    // test timeouts
+
+    explain("test timeouts", $ {
+        around_each({
+            run();
+            if (example.isAbandoned()) {
+                mytest::my_timeout_tail_runs++;
+            }
+        });
+        after_each({
+            if (example.isAbandoned()) {
+                mytest::my_timeout_tail_runs++;
+            }
+        });
+
+        it("should fail once it exceeds it's timeout (1)", _ {
+            mytest::my_timeout_fixtures.checkout(self);
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }).setTimeout(std::chrono::milliseconds(20));
+        it("should not run the hooks after an abandoned example", _ {
+            // long enough for the abandoned example to return
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            expect(mytest::my_timeout_tail_runs.load()).to_eq(0);
+        });
+        it("should replace fixtures kept by an abandoned example", _ {
+            // the pool has a limit of 1, so this would wait for the abandoned example forever
+            expect(mytest::my_timeout_fixtures.checkout(self).broken).to_eq(false);
+        }).setTimeout(std::chrono::seconds(1));
+    });
+
     // test exception throwing
 
     explain("test expect_throw", $ {
@@ -428,7 +760,93 @@ describe(mytest, $ {
             expect_no_throw([] { throw new std::runtime_error("test what of exception"); });
         });
     });
+
+    explain("test json formatter", $ {
+        it("should write valid json for any name", _ {
+            cxxspec::Spec spec("a \"quoted\"\tspec", [] (cxxspec::Spec& self) {
+                self._it("with a \\ and a\nnewline", __FILE__, [] (cxxspec::Example& self) {
+                    throw std::runtime_error("a \"quoted\" reason");
+                });
+            });
+            std::ostringstream out;
+            cxxspec::JsonFormatter formatter(out);
+            formatter.onBeginTesting();
+            spec.run(formatter, false);
+            formatter.onEndTesting();
+
+            expect(mytest::my_is_json(out.str())).to_eq(true);
+            expect(out.str()).to_contain("\"a \\\"quoted\\\"\\tspec\"");
+            expect(mytest::my_is_json("[{\"desc\": \"a \"quoted\" spec\"}]")).to_eq(false);
+        });
+    });
+
+    explain("test aggregate_failures", $ {
+        it("should report all failures of the block (1)", _ {
+            aggregate_failures({
+                expect(1).to_eq(2);
+                expect(3).to_eq(3);
+                expect(4).to_eq(5);
+            })
+            expect(6).to_eq(7);
+        });
+        it("should pass without failures (2)", _ {
+            aggregate_failures({
+                expect(1).to_eq(1);
+            })
+        });
+
+        context("for all examples", $ {
+            set_aggregate_failures(true)
+
+            it("should report all failures of the example (1)", _ {
+                expect(1).to_eq(2);
+                expect_throw(std::runtime_error, [] { });
+                expect(3).to_eq(4);
+            });
+        });
+    });
+});
+
+#ifdef CXXSPEC_HAS_COROUTINES
+#include <unistd.h>
+
+namespace mytest {
+    // loop of the first interleaved example while it runs & how far it got. With `--jobs` or `--isolate` every
+    // asynchronous example has a loop of it's own, so the order is only checked when both share a loop.
+    std::atomic<cxxspec::EventLoop*> my_async_loop(nullptr);
+    std::atomic<int> my_async_step(0);
+}
+
+describe(async_examples, $ {
+    it_async("should wait for a pipe", _async {
+        int fds[2];
+        expect(pipe(fds)).to_eq(0);
+        cleanup([=] { close(fds[0]); close(fds[1]); });
+
+        mytest::my_async_loop = cxxspec::EventLoop::current();
+        cleanup([] { mytest::my_async_loop = nullptr; });
+        mytest::my_async_step = 1;
+        co_await cxxspec::sleep_for(std::chrono::milliseconds(10));
+        mytest::my_async_step = 2;
+        expect(write(fds[1], "x", 1)).to_eq(1);
+        co_await cxxspec::readable(fds[0]);
+
+        char c = 0;
+        expect(read(fds[0], &c, 1)).to_eq(1);
+        expect(c).to_eq('x');
+    });
+    it_async("should run while the other one waits", _async {
+        bool shared = cxxspec::EventLoop::current() == mytest::my_async_loop.load();
+        if (shared) {
+            expect(mytest::my_async_step.load()).to_eq(1);
+        }
+        co_await cxxspec::yield();
+        if (shared) {
+            expect(mytest::my_async_step.load()).to_eq(1);
+        }
+    });
 });
+#endif
 
 int main(int argc, char** argv) {
     using namespace cxxspec;
@@ -0,0 +1,85 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace cxxspec {
+
+    /**
+     * Allocates objects of a single type in chunks of growing size; objects never move and are all destroyed
+     * (in reverse order of creation) together with the arena.
+     */
+    template<typename T>
+    class Arena {
+    public:
+        Arena() = default;
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        ~Arena() {
+            std::allocator<T> allocator;
+            for (auto chunk = this->chunks.rbegin(); chunk != this->chunks.rend(); chunk++) {
+                for (std::size_t i = chunk->used; i > 0; i--) {
+                    chunk->items[i - 1].~T();
+                }
+                allocator.deallocate(chunk->items, chunk->capacity);
+            }
+        }
+
+        template<typename... Args>
+        T* create(Args&&... args) {
+            if (this->chunks.empty() || this->chunks.back().used == this->chunks.back().capacity) {
+                std::size_t capacity = this->chunks.empty() ? firstChunk : this->chunks.back().capacity * 2;
+                if (capacity > lastChunk) {
+                    capacity = lastChunk;
+                }
+                this->chunks.push_back(Chunk{ std::allocator<T>().allocate(capacity), capacity, 0 });
+            }
+            Chunk& chunk = this->chunks.back();
+            T* item = new (chunk.items + chunk.used) T(std::forward<Args>(args)...);
+            chunk.used++;
+            this->count++;
+            return item;
+        }
+
+        std::size_t size() const {
+            return this->count;
+        }
+
+    private:
+        enum : std::size_t {
+            firstChunk = 8,
+            lastChunk = 4096,
+        };
+
+        struct Chunk {
+            T* items;
+            std::size_t capacity;
+            std::size_t used;
+        };
+
+        std::vector<Chunk> chunks;
+        std::size_t count = 0;
+    };
+
+}
\ No newline at end of file
@@ -0,0 +1,285 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./core.hpp"
+#include "./event_loop.hpp"
+
+#if defined(__has_include)
+    #if __has_include(<coroutine>) && defined(__cpp_impl_coroutine) && defined(CXXSPEC_HAS_EXCEPTIONS)
+        #define CXXSPEC_HAS_COROUTINES 1
+    #endif
+#endif
+
+#ifdef CXXSPEC_HAS_COROUTINES
+
+#include <coroutine>
+#include <stdexcept>
+#include <utility>
+
+namespace cxxspec {
+
+    /**
+     * Coroutine type of asynchronous examples (and of helpers they `co_await`). A task starts suspended and runs once
+     * it's either started by the event loop or awaited by another task.
+     */
+    class Task {
+    public:
+        struct promise_type {
+            std::coroutine_handle<> continuation;
+            std::function<void()> onDone;
+            std::exception_ptr error;
+            bool finished = false;
+
+            Task get_return_object() noexcept {
+                return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() noexcept {
+                return {};
+            }
+
+            struct FinalAwaiter {
+                bool await_ready() noexcept {
+                    return false;
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> self) noexcept {
+                    promise_type& promise = self.promise();
+                    promise.finished = true;
+                    if (promise.continuation) {
+                        return promise.continuation;
+                    }
+                    if (promise.onDone) {
+                        promise.onDone();
+                    }
+                    return std::noop_coroutine();
+                }
+
+                void await_resume() noexcept {}
+            };
+
+            FinalAwaiter final_suspend() noexcept {
+                return {};
+            }
+
+            void return_void() noexcept {}
+
+            void unhandled_exception() noexcept {
+                this->error = std::current_exception();
+            }
+        };
+
+        typedef std::coroutine_handle<promise_type> Handle;
+
+        explicit Task(Handle handle) : handle(handle) {}
+
+        Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        ~Task() {
+            if (this->handle) {
+                this->handle.destroy();
+            }
+        }
+
+        promise_type& promise() const {
+            return this->handle.promise();
+        }
+
+        void resume() const {
+            this->handle.resume();
+        }
+
+        // awaiting a task runs it until it completes; exceptions are passed on to the awaiting task
+
+        bool await_ready() const noexcept {
+            return this->handle.done();
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+            this->handle.promise().continuation = awaiting;
+            return this->handle;
+        }
+
+        void await_resume() const {
+            if (this->handle.promise().error) {
+                std::rethrow_exception(this->handle.promise().error);
+            }
+        }
+
+    private:
+        Handle handle;
+    };
+
+    /**
+     * Adapts a task to the run of an asynchronous example
+     */
+    class TaskRun : public AsyncRun {
+    public:
+        explicit TaskRun(Task&& task) : task(std::move(task)) {}
+
+        ~TaskRun() {
+            // in case the loop didn't get to start the task
+            if (this->loop != nullptr) {
+                this->loop->cancel(this->startHandle);
+            }
+        }
+
+        void start(EventLoop& loop, std::function<void()> onDone) override {
+            this->task.promise().onDone = onDone;
+            this->loop = &loop;
+            this->startHandle = loop.post([this] () {
+                this->loop = nullptr;
+                this->task.resume();
+            });
+        }
+
+        bool done() const override {
+            return this->task.promise().finished;
+        }
+
+        std::exception_ptr error() const override {
+            return this->task.promise().error;
+        }
+
+    private:
+        Task task;
+        EventLoop* loop = nullptr;
+        EventLoop::Handle startHandle = 0;
+    };
+
+    /**
+     * Base of all awaitables suspending on the event loop; a registration that hasn't fired when
+     * the awaiting coroutine gets destroyed (i.e. after a timeout) is cancelled
+     */
+    class LoopAwaiter {
+    public:
+        LoopAwaiter() = default;
+        LoopAwaiter(const LoopAwaiter&) = delete;
+        LoopAwaiter& operator=(const LoopAwaiter&) = delete;
+
+        ~LoopAwaiter() {
+            if (this->loop != nullptr && !this->fired) {
+                this->loop->cancel(this->handle);
+            }
+        }
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        void await_resume() const noexcept {}
+
+    protected:
+        EventLoop& currentLoop() const {
+            EventLoop* loop = EventLoop::current();
+            if (loop == nullptr) {
+                throw std::runtime_error("Can only wait for events inside of an asynchronous example");
+            }
+            return *loop;
+        }
+
+        std::function<void()> resumer(std::coroutine_handle<> awaiting) {
+            return [this, awaiting] () {
+                this->fired = true;
+                awaiting.resume();
+            };
+        }
+
+        EventLoop* loop = nullptr;
+        EventLoop::Handle handle = 0;
+        bool fired = false;
+    };
+
+    class FdAwaiter : public LoopAwaiter {
+    public:
+        FdAwaiter(int fd, EventLoop::Interest interest) : fd(fd), interest(interest) {}
+
+        void await_suspend(std::coroutine_handle<> awaiting) {
+            this->loop = &this->currentLoop();
+            this->handle = this->loop->watch(this->fd, this->interest, this->resumer(awaiting));
+        }
+
+    private:
+        int fd;
+        EventLoop::Interest interest;
+    };
+
+    class TimerAwaiter : public LoopAwaiter {
+    public:
+        explicit TimerAwaiter(ExampleDuration delay) : delay(delay) {}
+
+        void await_suspend(std::coroutine_handle<> awaiting) {
+            this->loop = &this->currentLoop();
+            if (this->delay > ExampleDuration::zero()) {
+                this->handle = this->loop->after(this->delay, this->resumer(awaiting));
+            }
+            else {
+                this->handle = this->loop->post(this->resumer(awaiting));
+            }
+        }
+
+    private:
+        ExampleDuration delay;
+    };
+
+    /**
+     * Suspends until the fd can be read from without blocking
+     */
+    inline FdAwaiter readable(int fd) {
+        return FdAwaiter(fd, EventLoop::WAIT_READABLE);
+    }
+
+    /**
+     * Suspends until the fd can be written to without blocking
+     */
+    inline FdAwaiter writable(int fd) {
+        return FdAwaiter(fd, EventLoop::WAIT_WRITABLE);
+    }
+
+    /**
+     * Suspends for (at least) the given time
+     */
+    template<typename Rep, typename Period>
+    inline TimerAwaiter sleep_for(std::chrono::duration<Rep, Period> delay) {
+        return TimerAwaiter(std::chrono::duration_cast<ExampleDuration>(delay));
+    }
+
+    /**
+     * Lets the other examples on the loop run before continuing
+     */
+    inline TimerAwaiter yield() {
+        return TimerAwaiter(ExampleDuration::zero());
+    }
+
+    template<typename AsyncBlock>
+    inline Example& _it_async(Spec& spec, const char* name, const char* sourcefile, AsyncBlock block) {
+        Example& ex = spec._it(name, sourcefile, [] (Example&) {});
+        ex.setAsync([block] (Example& self) -> std::unique_ptr<AsyncRun> {
+            return std::unique_ptr<AsyncRun>(new TaskRun(block(self)));
+        });
+        return ex;
+    }
+
+}
+
+#endif
\ No newline at end of file
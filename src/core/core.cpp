@@ -18,17 +18,93 @@
 
 #include "./core/core.hpp"
 #include "./core/exceptions.hpp"
+#include "./core/watchdog.hpp"
+#include "./core/event_loop.hpp"
 
 #include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 
 namespace cxxspec {
 
-    void Example::run(Formatter& formatter, bool hasNextExample) {
+    Example::~Example() {
+        if (this->abandoned) {
+            // the values may still be in use by the thread running the example
+            this->memos.release();
+        }
+    }
+
+    void Example::run(Formatter& formatter, bool hasNextExample, Watchdog* watchdog) {
+        formatter.onEnterExample(*this);
+
+        if (watchdog != nullptr) {
+            this->_result = watchdog->execute(*this, [this] () {
+                ExampleResult result = this->invoke();
+                this->runCleanup();
+                this->finish();
+                return result;
+            });
+        }
+        else {
+            this->execute();
+            this->runCleanup();
+            this->finish();
+        }
+        formatter.onExampleResult(*this, this->_result.success, this->_result.reason, this->_result.timeTaken);
+
+        formatter.onLeaveExample(*this, hasNextExample);
+    }
+
+    void Example::execute() {
+        this->_result = this->invoke();
+    }
+
+    /**
+     * Turns the exception an example failed with into the reason of it's result; exceptions that aren't understood are rethrown
+     */
+    static void describeFailure(ExampleResult& result, std::exception_ptr error) {
+        try {
+            std::rethrow_exception(error);
+        }
+        catch (ExpectFailError e) {
+            result.reason = e.what();
+        }
+        catch (const std::exception& e) {
+            std::stringstream ss;
+            ss << "Throwed uncatched & unexpected exception: (" << util::current_exception_typename() << ") => " << e.what();
+            result.reason = ss.str();
+        }
+        catch (const std::exception* e) {
+            std::stringstream ss;
+            ss << "Throwed uncatched & unexpected exception: (" << util::current_exception_typename() << ") => " << e->what();
+            delete e;
+            result.reason = ss.str();
+        }
+    }
+
+    ExampleResult Example::invoke() {
         using std::chrono::high_resolution_clock;
         using time_point = std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds>;
 
-        formatter.onEnterExample(*this);
+        if (this->isAsync()) {
+            // on it's own (i.e. on a worker), an asynchronous example gets a loop to itself
+            EventLoop loop;
+            time_point startPoint = high_resolution_clock::now();
+            std::unique_ptr<AsyncRun> run = this->startAsync(loop, [] () {});
+            loop.run([&run] () { return run->done(); });
+            return this->asyncResult(*run, high_resolution_clock::now() - startPoint);
+        }
+
+        this->failure = FailureRecord();
+        if (this->aggregatesFailures()) {
+            this->failure.aggregating = 1;
+        }
+
+        ExampleResult result;
 
         time_point startPoint;
         time_point endPoint;
@@ -37,38 +113,113 @@ namespace cxxspec {
             this->block(*this);
             endPoint = high_resolution_clock::now();
 
-            ExampleDuration diff = endPoint - startPoint;
-            formatter.onExampleResult(*this, true, "", diff);
+            result.success = !this->failure.failed;
+            result.reason = this->failure.summary();
         }
-        catch (ExpectFailError e) {
+        catch (...) {
             endPoint = high_resolution_clock::now();
 
-            ExampleDuration diff = endPoint - startPoint;
-            formatter.onExampleResult(*this, false, e.what(), diff);
+            describeFailure(result, std::current_exception());
+            if (this->failure.aggregating > 0) {
+                // thrown while aggregating, so it's just one more failure
+                this->failure.fail(result.reason);
+                result.reason = this->failure.summary();
+            }
+            else if (this->failure.failed) {
+                // whatever was thrown most likely followed from the recorded failure(s)
+                result.reason = this->failure.summary();
+            }
         }
-        catch (const std::exception& e) {
-            endPoint = high_resolution_clock::now();
 
-            ExampleDuration diff = endPoint - startPoint;
-            std::stringstream ss;
-            ss << "Throwed uncatched & unexpected exception: (" << util::current_exception_typename() << ") => " << e.what();
-            formatter.onExampleResult(*this, false, ss.str(), diff);
-        }
-        catch (const std::exception* e) {
-            endPoint = high_resolution_clock::now();
+        result.timeTaken = endPoint - startPoint;
+        return result;
+    }
 
-            ExampleDuration diff = endPoint - startPoint;
-            std::stringstream ss;
-            ss << "Throwed uncatched & unexpected exception: (" << util::current_exception_typename() << ") => " << e->what();
-            delete e;
-            formatter.onExampleResult(*this, false, ss.str(), diff);
+    std::unique_ptr<AsyncRun> Example::startAsync(EventLoop& loop, std::function<void()> onDone) {
+        this->failure = FailureRecord();
+        if (this->aggregatesFailures()) {
+            this->failure.aggregating = 1;
         }
+        std::unique_ptr<AsyncRun> run = this->asyncBlock(*this);
+        run->start(loop, onDone);
+        return run;
+    }
 
-        formatter.onLeaveExample(*this, hasNextExample);
+    ExampleResult Example::asyncResult(const AsyncRun& run, ExampleDuration timeTaken) const {
+        ExampleResult result;
+        result.timeTaken = timeTaken;
+        if (this->failure.failed) {
+            result.reason = this->failure.summary();
+        }
+        else if (!run.done()) {
+            result.reason = "Never completed: it's waiting for something that nothing will trigger";
+        }
+        else if (run.error()) {
+            describeFailure(result, run.error());
+        }
+        else {
+            result.success = true;
+        }
+        return result;
+    }
 
+    void Example::runCleanup() {
+        if (this->abandoned) {
+            // the blocks belong to the thread that is still running the example
+            return;
+        }
         for (CleanupBlock& block : this->cleanupBlocks) {
             block();
         }
+        this->cleanupBlocks.clear();
+    }
+
+    // examples are only abandoned after a timeout, so a single lock for all of them is enough
+    static std::mutex abandonMutex;
+
+    void Example::abandon() {
+        std::vector<CleanupBlock> blocks;
+        {
+            std::lock_guard<std::mutex> lock(abandonMutex);
+            this->abandoned = true;
+            blocks.swap(this->abandonBlocks);
+        }
+        for (CleanupBlock& block : blocks) {
+            block();
+        }
+    }
+
+    void Example::onAbandon(CleanupBlock block) {
+        {
+            std::lock_guard<std::mutex> lock(abandonMutex);
+            if (!this->abandoned) {
+                this->abandonBlocks.push_back(block);
+                return;
+            }
+        }
+        block();
+    }
+
+    void Example::finish() {
+        {
+            std::lock_guard<std::mutex> lock(abandonMutex);
+            if (this->abandoned) {
+                return;
+            }
+            this->abandonBlocks.clear();
+        }
+        this->memos.reset();
+    }
+
+    void Example::report(Formatter& formatter, bool hasNextExample) {
+        formatter.onEnterExample(*this);
+        if (this->_result.skipped) {
+            formatter.onExampleSkipped(*this, this->_result.reason);
+        }
+        else {
+            formatter.onExampleResult(*this, this->_result.success, this->_result.reason, this->_result.timeTaken);
+        }
+        formatter.onLeaveExample(*this, hasNextExample);
     }
 
     void Example::expect_no_throw(ExBlock block) {
@@ -78,33 +229,51 @@ namespace cxxspec {
         catch (const std::exception& e) {
             std::stringstream ss;
             ss << "Expected to not throw, but did: (" << util::demangle(typeid(e).name()) << ") => " << e.what();
-            throw ExpectFailError(ss.str());
+            failExpectation(ss.str(), &this->failure);
         }
         catch (const std::exception* e) {
             std::stringstream ss;
             ss << "Expected to not throw, but did: (" << util::demangle(typeid(e).name()) << ") => " << e->what();
             delete e;
-            throw ExpectFailError(ss.str());
+            failExpectation(ss.str(), &this->failure);
         }
         catch (const std::string& e) {
             std::stringstream ss;
             ss << "Expected to not throw, but did: \"" << e << '"';
-            throw ExpectFailError(ss.str());
+            failExpectation(ss.str(), &this->failure);
         }
         catch (const char* e) {
             std::stringstream ss;
             ss << "Expected to not throw, but did: \"" << e << '"';
-            throw ExpectFailError(ss.str());
+            failExpectation(ss.str(), &this->failure);
         }
         catch (...) {
             std::stringstream ss;
             ss << "Expected to not throw, but did (" << util::current_exception_typename() << ")";
-            throw ExpectFailError(ss.str());
+            failExpectation(ss.str(), &this->failure);
         }
     }
 
     //--------------------------------------------------------------------------------
 
+    Spec::Spec(const std::string& desc, Block block, DescribeAble* parent)
+        : _desc(&util::intern(desc)), block(block), parent(parent)
+    {
+        this->_fulldesc.reset(new std::string(parent == nullptr ? desc : parent->fulldesc() + " " + desc));
+    }
+
+    Spec::Spec(Spec&& other) noexcept = default;
+    Spec& Spec::operator=(Spec&& other) noexcept = default;
+    Spec::~Spec() = default;
+
+    Spec::Tree& Spec::tree() {
+        if (this->_tree == nullptr) {
+            this->ownTree.reset(new Tree());
+            this->_tree = this->ownTree.get();
+        }
+        return *this->_tree;
+    }
+
     void Spec::run_spec_hooks(HookType type) {
         for (auto& e : this->spec_hooks) {
             if (e.first == type) {
@@ -114,16 +283,174 @@ namespace cxxspec {
     }
 
     void Spec::run_example_hooks(HookType type, Example& ex) {
-        // when hook is for each, first run the hooks in the parent
-        if (this->parent && dynamic_cast<Spec*>(this->parent)) {
-            // TODO: this is an ugly hack, but I didn't want to extend DescribeAble with the run_hooks() method; needs to be changed
-            ((Spec*)this->parent)->run_example_hooks(type, ex);
+        for (const ExampleHookBlock* hook : this->getHookChain(type)) {
+            (*hook)(ex);
         }
+    }
 
-        for (auto& e : this->example_hooks) {
-            if (e.first == type) {
-                e.second(ex);
+    bool Spec::run_around_all_hooks(const Continuation& body) {
+        bool ran = false;
+        Continuation next = [&ran, &body] () {
+            ran = true;
+            body();
+        };
+        // the first hook added is the outermost one
+        for (auto hook = this->around_all_hooks.rbegin(); hook != this->around_all_hooks.rend(); hook++) {
+            const AroundAllBlock& block = *hook;
+            next = [&block, next] () { block(next); };
+        }
+        next();
+        return ran;
+    }
+
+    /**
+     * Thrown out of the continuation of the around_each hooks to unwind them once their example was abandoned
+     */
+    struct AbandonedExample {};
+
+    bool Spec::run_around_each_hooks(Example& ex, const Continuation& body) {
+        if (this->aroundEachChain.empty()) {
+            body();
+            return true;
+        }
+
+        bool ran = false;
+        Continuation next = [&ran, &ex, &body] () {
+            ran = true;
+            body();
+            if (ex.isAbandoned()) {
+                // the example is still running; the code after `run()` would race with it
+                throw AbandonedExample();
+            }
+        };
+        for (auto hook = this->aroundEachChain.rbegin(); hook != this->aroundEachChain.rend(); hook++) {
+            const AroundEachBlock& block = **hook;
+            next = [&block, &ex, next] () { block(ex, next); };
+        }
+        try {
+            next();
+        }
+        catch (const AbandonedExample&) {}
+        return ran;
+    }
+
+    ExampleResult Spec::executeExample(Example& ex, Watchdog* watchdog) {
+        // only pointers are captured, as an abandoned example keeps running after we returned
+        Spec* spec = this;
+        Example* example = &ex;
+        std::function<ExampleResult()> task = [spec, example] () {
+            ExampleResult result;
+            bool ran;
+            try {
+                ran = spec->run_around_each_hooks(*example, [spec, example, &result] () {
+                    spec->run_example_hooks(HOOK_BEFORE, *example);
+                    result = example->invoke();
+                    if (example->isAbandoned()) {
+                        return;
+                    }
+                    example->runCleanup();
+                    spec->run_example_hooks(HOOK_AFTER, *example);
+                });
+            }
+            catch (...) {
+                // the same with or without `--jobs`: the example fails, the run goes on
+                result = ExampleResult();
+                result.reason = "Hook failed: " + util::describe_current_exception();
+                example->finish();
+                return result;
+            }
+            example->finish();
+            return ran ? result : aroundEachSkippedResult();
+        };
+
+        if (watchdog == nullptr) {
+            return task();
+        }
+        return watchdog->execute(ex, task);
+    }
+
+    ExampleResult aroundEachSkippedResult() {
+        ExampleResult result;
+        result.reason = "An around_each hook didn't run the example";
+        return result;
+    }
+
+    struct Spec::Scope {
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable cond;
+        bool entered = false;
+        bool leaving = false;
+        bool done = false;
+        std::exception_ptr error;
+    };
+
+    void Spec::enter() {
+        if (this->around_all_hooks.empty()) {
+            this->run_spec_hooks(HOOK_BEFORE);
+            return;
+        }
+
+        this->scope.reset(new Scope());
+        Scope& scope = *this->scope;
+        scope.thread = std::thread([this, &scope] () {
+            try {
+                this->run_around_all_hooks([this, &scope] () {
+                    this->run_spec_hooks(HOOK_BEFORE);
+
+                    std::unique_lock<std::mutex> lock(scope.mutex);
+                    scope.entered = true;
+                    scope.cond.notify_all();
+                    scope.cond.wait(lock, [&scope] () { return scope.leaving; });
+                    lock.unlock();
+
+                    this->run_spec_hooks(HOOK_AFTER);
+                });
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(scope.mutex);
+                scope.error = std::current_exception();
             }
+
+            std::lock_guard<std::mutex> lock(scope.mutex);
+            scope.done = true;
+            scope.cond.notify_all();
+        });
+
+        std::unique_lock<std::mutex> lock(scope.mutex);
+        scope.cond.wait(lock, [&scope] () { return scope.entered || scope.done; });
+        if (scope.entered) {
+            return;
+        }
+        lock.unlock();
+
+        scope.thread.join();
+        std::exception_ptr error = scope.error;
+        this->scope.reset();
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        throw std::runtime_error("An around_all hook didn't run the examples");
+    }
+
+    void Spec::leave() {
+        if (!this->scope) {
+            this->run_spec_hooks(HOOK_AFTER);
+            return;
+        }
+
+        Scope& scope = *this->scope;
+        {
+            std::lock_guard<std::mutex> lock(scope.mutex);
+            scope.leaving = true;
+        }
+        scope.cond.notify_all();
+        scope.thread.join();
+
+        std::exception_ptr error = scope.error;
+        this->scope.reset();
+        if (error) {
+            std::rethrow_exception(error);
         }
     }
 
@@ -133,54 +460,369 @@ namespace cxxspec {
         // this defines sub-specs and examples
         this->block(*this);
         this->defined = true;
+
+        // parents are always defined before their childs, so their chains are complete already
+        if (this->parentSpec != nullptr) {
+            this->beforeEachChain = this->parentSpec->beforeEachChain;
+            this->afterEachChain = this->parentSpec->afterEachChain;
+            this->aroundEachChain = this->parentSpec->aroundEachChain;
+        }
+        for (auto& hook : this->example_hooks) {
+            (hook.first == HOOK_BEFORE ? this->beforeEachChain : this->afterEachChain).push_back(&hook.second);
+        }
+        for (auto& hook : this->around_each_hooks) {
+            this->aroundEachChain.push_back(&hook);
+        }
     }
 
-    void Spec::run(Formatter& formatter, bool hasNextSpec) {
+    std::size_t Spec::selectExamples(const ExampleFilter& filter) {
+        if (this->filtered && this->selectedCount == 0) {
+            // filters only ever narrow the selection, so there is nothing left to look at
+            return 0;
+        }
+
         this->defineChilds();
 
-        formatter.onEnterSpec(*this);
-        this->run_spec_hooks(HOOK_BEFORE);
+        std::size_t count = 0;
+        for (Spec* spec : this->subspecs) {
+            count += spec->selectExamples(filter);
+        }
+        for (Example* ex : this->examples) {
+            if (ex->isSelected() && !filter(*ex)) {
+                ex->setSelected(false);
+            }
+            if (ex->isSelected()) {
+                count++;
+            }
+        }
+
+        this->filtered = true;
+        this->selectedCount = count;
+        return count;
+    }
+
+    std::size_t Spec::selectIndexed(const PathIndex::Node& node) {
+        if (node.whole) {
+            return this->selectExamples([] (const Example&) -> bool { return true; });
+        }
+        if (this->filtered && this->selectedCount == 0) {
+            return 0;
+        }
+
+        this->defineChilds();
+
+        std::size_t count = 0;
+        for (Spec* spec : this->subspecs) {
+            const PathIndex::Node* child = node.child(spec->desc());
+            if (child != nullptr) {
+                count += spec->selectIndexed(*child);
+            }
+            else {
+                // not part of the index, so there is no need to define it
+                spec->deselect();
+            }
+        }
+        for (Example* ex : this->examples) {
+            if (ex->isSelected() && node.examples.count(ex->name()) == 0) {
+                ex->setSelected(false);
+            }
+            if (ex->isSelected()) {
+                count++;
+            }
+        }
+
+        this->filtered = true;
+        this->selectedCount = count;
+        return count;
+    }
+
+    bool Spec::prioritize(const PathIndex::Node& node) {
+        if (node.empty() || !this->isSelected()) {
+            return false;
+        }
+
+        this->defineChilds();
+
+        bool any = node.whole;
+        for (Spec* spec : this->subspecs) {
+            const PathIndex::Node* child = node.whole ? &node : node.child(spec->desc());
+            if (child != nullptr && spec->prioritize(*child)) {
+                any = true;
+            }
+        }
+        for (Example* ex : this->examples) {
+            if (node.whole || node.examples.count(ex->name()) > 0) {
+                ex->setPrioritized(true);
+                any = true;
+            }
+        }
+
+        this->prioritized = this->prioritized || any;
+        return any;
+    }
+
+    std::vector<Spec*> Spec::selectedSubSpecs() {
+        std::vector<Spec*> list;
+        list.reserve(this->subspecs.size());
+        for (Spec* spec : this->subspecs) {
+            if (spec->isSelected()) {
+                list.push_back(spec);
+            }
+        }
+        std::stable_partition(list.begin(), list.end(), [] (const Spec* spec) { return spec->isPrioritized(); });
+        return list;
+    }
+
+    std::vector<Example*> Spec::selectedExamples() {
+        std::vector<Example*> list;
+        list.reserve(this->examples.size());
+        for (Example* ex : this->examples) {
+            if (ex->isSelected()) {
+                list.push_back(ex);
+            }
+        }
+        std::stable_partition(list.begin(), list.end(), [] (const Example* ex) { return ex->isPrioritized(); });
+        return list;
+    }
+
+    void Spec::run(Formatter& formatter, bool hasNextSpec, FailureBudget* budget, Watchdog* watchdog) {
+        if (budget != nullptr && budget->exhausted()) {
+            this->skip(formatter, hasNextSpec, budget->skippedResult());
+            return;
+        }
+
+        this->defineChilds();
+
+        // how far the spec got; a failing hook is handled the same way as by the scheduler of `--jobs`
+        enum { OUTSIDE, ENTERED, RUNNING, RAN, LEFT } stage = OUTSIDE;
+        bool ran = false;
+        try {
+            ran = this->run_around_all_hooks([&] () {
+                formatter.onEnterSpec(*this);
+                stage = ENTERED;
+                this->run_spec_hooks(HOOK_BEFORE);
+                stage = RUNNING;
+                this->runContents(formatter, budget, watchdog);
+                stage = RAN;
+                this->run_spec_hooks(HOOK_AFTER);
+                formatter.onLeaveSpec(*this, hasNextSpec);
+                stage = LEFT;
+            });
+        }
+        catch (...) {
+            if (stage == RUNNING) {
+                throw;
+            }
+            ran = true;
 
-        int subspecLimit = this->subspecs.size() - 1;
+            if (stage == OUTSIDE || stage == ENTERED) {
+                // a failing before_all or around_all hook fails every example of the spec
+                ExampleResult result;
+                result.reason = "before_all/around_all hook failed: " + util::describe_current_exception();
+                if (stage == OUTSIDE) {
+                    formatter.onEnterSpec(*this);
+                }
+                this->skipContents(formatter, result, budget);
+                formatter.onLeaveSpec(*this, hasNextSpec);
+            }
+            else {
+                // the examples are reported already
+                if (stage == RAN) {
+                    formatter.onLeaveSpec(*this, hasNextSpec);
+                }
+                std::cerr << "cxxspec: after_all/around_all hook of '" << this->fulldesc() << "' failed: "
+                          << util::describe_current_exception() << "\n";
+            }
+        }
+        if (!ran) {
+            ExampleResult result;
+            result.reason = "An around_all hook didn't run the examples";
+            this->skip(formatter, hasNextSpec, result);
+        }
+        this->runs += 1;
+    }
+
+    void Spec::runContents(Formatter& formatter, FailureBudget* budget, Watchdog* watchdog) {
+        std::vector<Spec*> subspecs = this->selectedSubSpecs();
+        std::vector<Example*> examples = this->selectedExamples();
+
+        int subspecLimit = subspecs.size() - 1;
         for (int i = 0; i <= subspecLimit; i++) {
-            Spec& spec = this->subspecs.at(i);
-            spec.run(formatter, i < subspecLimit || this->examples.size() > 0);
+            Spec& spec = *subspecs.at(i);
+            spec.run(formatter, i < subspecLimit || examples.size() > 0, budget, watchdog);
         }
 
-        int exampleLimit = this->examples.size() - 1;
+        // all asynchronous examples run at once, so a failure among them can't stop the others; around_each hooks need
+        // the example to be done once they continue, so with them every example runs on it's own
+        std::vector<bool> ranAsync(examples.size(), false);
+        if ((budget == nullptr || !budget->exhausted()) && this->aroundEachChain.empty()) {
+            ranAsync = this->runAsync(examples, watchdog);
+        }
+
+        int exampleLimit = examples.size() - 1;
         for (int i = 0; i <= exampleLimit; i++) {
-            Example& ex = this->examples.at(i);
-            this->run_example_hooks(HOOK_BEFORE, ex);
-            ex.run(formatter, i < exampleLimit);
-            this->run_example_hooks(HOOK_AFTER, ex);
+            Example& ex = *examples.at(i);
+            if (ranAsync[i]) {
+                // already done; only finished & reported in order
+                ex.runCleanup();
+                try {
+                    this->run_example_hooks(HOOK_AFTER, ex);
+                }
+                catch (...) {
+                    ExampleResult result;
+                    result.reason = "Hook failed: " + util::describe_current_exception();
+                    ex.setResult(result);
+                }
+                ex.finish();
+                ex.report(formatter, i < exampleLimit);
+                if (budget != nullptr) {
+                    budget->account(ex.result());
+                }
+                continue;
+            }
+            if (budget != nullptr && budget->exhausted()) {
+                ex.setResult(budget->skippedResult());
+                ex.report(formatter, i < exampleLimit);
+                continue;
+            }
+            ex.setResult(this->executeExample(ex, watchdog));
+            ex.report(formatter, i < exampleLimit);
+            if (budget != nullptr) {
+                budget->account(ex.result());
+            }
         }
+    }
+
+    std::vector<bool> Spec::runAsync(const std::vector<Example*>& examples, Watchdog* watchdog) {
+        typedef std::chrono::steady_clock Clock;
+        struct Pending {
+            std::unique_ptr<AsyncRun> run;
+            Clock::time_point start;
+            EventLoop::Handle timer = 0;
+        };
+
+        std::vector<bool> ran(examples.size(), false);
+        std::vector<Pending> pending(examples.size());
+        std::size_t remaining = 0;
+        std::unique_ptr<EventLoop> loop;
+
+        for (std::size_t i = 0; i < examples.size(); i++) {
+            Example& ex = *examples[i];
+            if (!ex.isAsync()) {
+                continue;
+            }
+            if (!loop) {
+                loop.reset(new EventLoop());
+            }
+
+            ran[i] = true;
+            try {
+                this->run_example_hooks(HOOK_BEFORE, ex);
+            }
+            catch (...) {
+                ExampleResult result;
+                result.reason = "Hook failed: " + util::describe_current_exception();
+                ex.setResult(result);
+                continue;
+            }
+            remaining++;
 
-        this->run_spec_hooks(HOOK_AFTER);
+            Pending& entry = pending[i];
+            entry.start = Clock::now();
+            entry.run = ex.startAsync(*loop, [&, i] () {
+                Pending& entry = pending[i];
+                loop->cancel(entry.timer);
+                examples[i]->setResult(examples[i]->asyncResult(*entry.run, Clock::now() - entry.start));
+                remaining--;
+            });
+
+            ExampleDuration timeout = watchdog != nullptr ? watchdog->timeoutOf(ex) : ex.timeout();
+            if (timeout > ExampleDuration::zero()) {
+                entry.timer = loop->after(timeout, [&, i] () {
+                    Pending& entry = pending[i];
+                    ExampleResult result;
+                    result.timeTaken = Clock::now() - entry.start;
+                    result.reason = timeoutReason(result.timeTaken);
+                    examples[i]->setResult(result);
+                    // unlike a thread, a coroutine can be stopped; it's cleanup blocks are still run as usual
+                    entry.run.reset();
+                    remaining--;
+                });
+            }
+        }
+
+        if (remaining == 0) {
+            return ran;
+        }
+        loop->run([&remaining] () { return remaining == 0; });
+
+        // whatever is left waits for something that can't happen anymore
+        for (std::size_t i = 0; i < examples.size(); i++) {
+            Pending& entry = pending[i];
+            if (entry.run && !entry.run->done()) {
+                loop->cancel(entry.timer);
+                examples[i]->setResult(examples[i]->asyncResult(*entry.run, Clock::now() - entry.start));
+                entry.run.reset();
+            }
+        }
+        return ran;
+    }
+
+    void Spec::skip(Formatter& formatter, bool hasNextSpec, const ExampleResult& result) {
+        // defining only runs the spec block, not any hooks; it's needed to report every skipped example
+        this->defineChilds();
+
+        formatter.onEnterSpec(*this);
+        this->skipContents(formatter, result, nullptr);
         formatter.onLeaveSpec(*this, hasNextSpec);
-        this->runs += 1;
     }
 
-    void Spec::runMarkedOnly(Formatter& formatter, bool hasNextSpec) {
-        if (this->marked) {
-            // run normaly all subspecs & examples
-            this->run(formatter, hasNextSpec);
+    void Spec::skipContents(Formatter& formatter, const ExampleResult& result, FailureBudget* budget) {
+        std::vector<Spec*> subspecs = this->selectedSubSpecs();
+        std::vector<Example*> examples = this->selectedExamples();
+
+        int subspecLimit = subspecs.size() - 1;
+        for (int i = 0; i <= subspecLimit; i++) {
+            Spec& spec = *subspecs.at(i);
+            spec.defineChilds();
+            formatter.onEnterSpec(spec);
+            spec.skipContents(formatter, result, budget);
+            formatter.onLeaveSpec(spec, i < subspecLimit || examples.size() > 0);
         }
-        else if (this->markedSubSpecs) {
-            // run runMarkedOnly on subspecs that are either isMarked() or hasMarkedSubSpecs()
 
-            this->subspecs.erase(
-                std::remove_if(this->subspecs.begin(), this->subspecs.end(), [] (Spec& spec) -> bool {
-                    return !spec.isMarked() && !spec.hasMarkedSubSpecs();
-                }),
-                this->subspecs.end()
-            );
+        int exampleLimit = examples.size() - 1;
+        for (int i = 0; i <= exampleLimit; i++) {
+            examples.at(i)->setResult(result);
+            examples.at(i)->report(formatter, i < exampleLimit);
+            if (budget != nullptr) {
+                budget->account(result);
+            }
+        }
+    }
+
+    std::size_t Spec::selectMarked() {
+        if (this->marked) {
+            return this->selectExamples([] (const Example&) -> bool { return true; });
+        }
 
-            int subspecLimit = this->subspecs.size() - 1;
-            for (int i = 0; i <= subspecLimit; i++) {
-                Spec& spec = this->subspecs.at(i);
-                spec.run(formatter, i < subspecLimit);
+        // unmarked parts of the tree are deselected without defining them
+        this->filtered = true;
+        this->selectedCount = 0;
+        if (this->markedSubSpecs) {
+            for (Example* ex : this->examples) {
+                ex->setSelected(false);
             }
+            for (Spec* spec : this->subspecs) {
+                this->selectedCount += spec->selectMarked();
+            }
+        }
+        return this->selectedCount;
+    }
 
+    void Spec::runMarkedOnly(Formatter& formatter, bool hasNextSpec) {
+        this->selectMarked();
+        if (this->marked || this->isSelected()) {
+            this->run(formatter, hasNextSpec);
         }
     }
 
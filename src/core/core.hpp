@@ -23,50 +23,299 @@
 #include <string>
 #include <sstream>
 #include <unordered_map> // for std::pair
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
 
 #include "./formatter.hpp"
 #include "./util.hpp"
 #include "./exceptions.hpp"
+#include "./path_index.hpp"
+#include "./arena.hpp"
 
 namespace cxxspec {
 
     // -- forward declaration --
     template<typename T_got>
     class Expectation;
+    class Watchdog;
+    class EventLoop;
     // -------------------------
 
     class DescribeAble {
     public:
-        virtual std::string fulldesc() const = 0;
-        virtual std::string desc() const = 0;
+        virtual const std::string& fulldesc() const = 0;
+        virtual const std::string& desc() const = 0;
+
+        /**
+         * Descriptions from the top-level spec down to this one
+         */
+        virtual std::vector<std::string> path() const {
+            return std::vector<std::string>{ this->desc() };
+        }
+
+        /**
+         * Time examples inside of this are allowed to take; zero if there is no limit
+         */
+        virtual ExampleDuration timeout() const {
+            return ExampleDuration::zero();
+        }
+
+        /**
+         * Whether examples inside of this aggregate all their failed expectations instead of stopping at the first
+         */
+        virtual bool aggregatesFailures() const {
+            return false;
+        }
+    };
+
+    /**
+     * Outcome of a single execution of an example
+     */
+    struct ExampleResult {
+        bool success = false;
+        std::string reason;
+        ExampleDuration timeTaken = ExampleDuration::zero();
+        // the example wasn't executed at all; `reason` tells why
+        bool skipped = false;
+    };
+
+    /**
+     * Counts failed examples of a run and tells when to stop; can be shared between threads
+     */
+    class FailureBudget {
+    public:
+        /**
+         * @param limit  number of failures after which all remaining examples are skipped; 0 for no limit
+         */
+        FailureBudget(std::size_t limit = 0) : limit(limit), failures(0) {}
+
+        void account(const ExampleResult& result) {
+            if (!result.success && !result.skipped) {
+                this->failures++;
+            }
+        }
+
+        bool exhausted() const {
+            return this->limit > 0 && this->failures.load() >= this->limit;
+        }
+
+        /**
+         * Result for examples that are skipped because the budget is exhausted
+         */
+        ExampleResult skippedResult() const {
+            ExampleResult result;
+            result.skipped = true;
+            result.reason = "Skipped after " + std::to_string(this->limit) + (this->limit == 1 ? " failure" : " failures");
+            return result;
+        }
+
+    private:
+        std::size_t limit;
+        std::atomic<std::size_t> failures;
+    };
+
+    /**
+     * A started execution of the body of an asynchronous example; implemented by the coroutine support in `async.hpp`.
+     * Destroying a run that isn't done yet cancels it.
+     */
+    class AsyncRun {
+    public:
+        virtual ~AsyncRun() {}
+
+        /**
+         * Starts the body on the loop; `onDone` is called from inside the loop once the body completed
+         */
+        virtual void start(EventLoop& loop, std::function<void()> onDone) = 0;
+
+        virtual bool done() const = 0;
+
+        /**
+         * Exception the body completed with; null if it succeeded
+         */
+        virtual std::exception_ptr error() const = 0;
     };
 
     class Example {
     public:
         typedef std::function<void (Example&)> Block;
+        typedef std::function<std::unique_ptr<AsyncRun> (Example&)> AsyncBlock;
         typedef std::function<void()> ExBlock;
         typedef std::function<void()> CleanupBlock;
 
-        Example(std::string name, Block block, DescribeAble* parent)
-            : _name(name), block(block), parent(parent)
+        Example(const std::string& name, Block block, DescribeAble* parent)
+            : _name(&util::intern(name)), _sourcefile(&util::intern("unknown")), block(block), parent(parent)
         {}
 
-        Example(std::string name, std::string sourcefile, Block block, DescribeAble* parent)
-            : _name(name), _sourcefile(sourcefile), block(block), parent(parent)
+        Example(const std::string& name, const std::string& sourcefile, Block block, DescribeAble* parent)
+            : _name(&util::intern(name)), _sourcefile(&util::intern(sourcefile)), block(block), parent(parent)
         {}
 
-        void run(Formatter& formatter, bool hasNextExample);
+        ~Example();
+
+        // examples live in the arena of their tree and never move
+        Example(const Example&) = delete;
+        Example& operator=(const Example&) = delete;
+
+        /**
+         * Executes the example (through the watchdog, if any) and reports the result
+         */
+        void run(Formatter& formatter, bool hasNextExample, Watchdog* watchdog = nullptr);
+
+        /**
+         * Runs the block of the example without reporting anything to a formatter;
+         * the outcome is stored and can be retrieved via `result()`.
+         */
+        void execute();
+
+        /**
+         * Runs the block of the example and returns the outcome without storing it; unlike `execute()` this
+         * doesn't touch the example itself besides the cleanup blocks & the failure record, so it can be run
+         * by a thread that may be abandoned.
+         */
+        ExampleResult invoke();
+
+        /**
+         * Replaces the block by an asynchronous one; it runs on an event loop, interleaved with the other
+         * asynchronous examples of the same spec
+         */
+        void setAsync(AsyncBlock block) {
+            this->asyncBlock = block;
+        }
+
+        bool isAsync() const {
+            return static_cast<bool>(this->asyncBlock);
+        }
+
+        /**
+         * Creates a run of the asynchronous block and starts it on the loop
+         */
+        std::unique_ptr<AsyncRun> startAsync(EventLoop& loop, std::function<void()> onDone);
+
+        /**
+         * Turns a (possibly unfinished) run into a result; a run that never finished failed
+         */
+        ExampleResult asyncResult(const AsyncRun& run, ExampleDuration timeTaken) const;
+
+        /**
+         * Runs (and then forgets) all cleanup blocks registered by the last execution
+         */
+        void runCleanup();
+
+        /**
+         * Ends the last execution once it's after_each & around_each hooks ran: destroys the memoized values and forgets
+         * the blocks registered via `onAbandon`. Does nothing for an abandoned example, as it's still running.
+         */
+        void finish();
+
+        /**
+         * Reports the stored result of the last execution to the formatter; skipped examples are reported via `onExampleSkipped`
+         */
+        void report(Formatter& formatter, bool hasNextExample);
+
+        const ExampleResult& result() const {
+            return this->_result;
+        }
+
+        /**
+         * Stores a result that was produced elsewhere (i.e. by an isolated worker process)
+         */
+        void setResult(const ExampleResult& result) {
+            this->_result = result;
+        }
+
+        /**
+         * Examples that are not selected are skipped (and not reported) when their spec runs
+         */
+        bool isSelected() const {
+            return this->selected;
+        }
+
+        void setSelected(bool selected) {
+            this->selected = selected;
+        }
+
+        /**
+         * Full description of the spec followed by the name; built on first use
+         */
+        const std::string& fullname() const {
+            std::call_once(this->fullnameOnce, [this] () {
+                this->_fullname.reset(new std::string(this->parent->fulldesc() + " " + *this->_name));
+            });
+            return *this->_fullname;
+        }
+
+        /**
+         * Path of the surrounding spec followed by the name of this example
+         */
+        std::vector<std::string> path() const {
+            std::vector<std::string> list = this->parent->path();
+            list.push_back(*this->_name);
+            return list;
+        }
+
+        /**
+         * Time this example is allowed to take; inherited from the surrounding specs if not set. Zero if there is no limit.
+         */
+        ExampleDuration timeout() const {
+            if (this->_timeout > ExampleDuration::zero()) {
+                return this->_timeout;
+            }
+            return this->parent->timeout();
+        }
+
+        Example& setTimeout(ExampleDuration timeout) {
+            this->_timeout = timeout;
+            return *this;
+        }
+
+        /**
+         * Whether all failed expectations of this example are reported at once; set for it or one of it's specs
+         */
+        bool aggregatesFailures() const {
+            return this->_aggregateFailures || this->parent->aggregatesFailures();
+        }
+
+        Example& setAggregateFailures(bool aggregate) {
+            this->_aggregateFailures = aggregate;
+            return *this;
+        }
+
+        /**
+         * Marks the example as given up on after it timed out and runs the blocks registered via `onAbandon`. It's still
+         * running on another thread, so it's cleanup blocks, after_each hooks and the rest of it's around_each hooks
+         * are left alone.
+         */
+        void abandon();
+
+        bool isAbandoned() const {
+            return this->abandoned;
+        }
+
+        /**
+         * Registers a block to run if the current execution is abandoned, i.e. to give up on resources other
+         * examples are waiting for; runs right away if it's abandoned already. Safe to call from the running example.
+         */
+        void onAbandon(CleanupBlock block);
+
+        /**
+         * Prioritized examples run (and are reported) before the others of their spec
+         */
+        bool isPrioritized() const {
+            return this->prioritized;
+        }
 
-        std::string fullname() const {
-            return this->parent->fulldesc() + " " + this->_name;
+        void setPrioritized(bool prioritized) {
+            this->prioritized = prioritized;
         }
 
-        std::string name() const {
-            return this->_name;
+        const std::string& name() const {
+            return *this->_name;
         }
 
-        std::string sourcefile() const {
-            return this->_sourcefile;
+        const std::string& sourcefile() const {
+            return *this->_sourcefile;
         }
 
         template<typename T>
@@ -91,11 +340,57 @@ namespace cxxspec {
             cleanupBlocks.push_back(cleanupblock);
         }
 
+        /**
+         * Value stored under the key for the current execution; created by `factory` on first access
+         * and destroyed once the after_each & around_each hooks ran
+         */
+        template<typename T, typename Factory>
+        T& memoize(const void* key, Factory factory) {
+            if (!this->memos) {
+                this->memos.reset(new std::unordered_map<const void*, std::shared_ptr<void>>());
+            }
+            auto it = this->memos->find(key);
+            if (it != this->memos->end()) {
+                return *static_cast<T*>(it->second.get());
+            }
+
+            // the factory may memoize other values, so it runs before anything is inserted
+            T* value = new T(factory());
+            (*this->memos)[key] = std::shared_ptr<void>(value);
+            return *value;
+        }
+
         template<typename T>
         Expectation<T> expect(const T& value) {
-            return Expectation<T>(value);
+            return Expectation<T>(value, &this->failure);
         }
 
+        /**
+         * Whether an expectation of the current execution failed and the example should stop; only ever true with
+         * `CXXSPEC_FAILURE_RECORDS`, as failed expectations throw otherwise. Never while failures are aggregated.
+         */
+        bool hasFailed() const {
+            return this->failure.isDecided();
+        }
+
+        /**
+         * Runs the block with all failed expectations being recorded instead of stopping it; afterwards the example
+         * fails with all of them at once. Blocks can be nested.
+         */
+        void aggregate_failures(const ExBlock& block) {
+            this->failure.aggregating++;
+            // anything thrown leaves the record aggregating, so `invoke()` adds it to the failures
+            block();
+            this->failure.aggregating--;
+
+            #if defined(CXXSPEC_HAS_EXCEPTIONS) && !defined(CXXSPEC_FAILURE_RECORDS)
+                if (this->failure.failed && this->failure.aggregating == 0) {
+                    throw ExpectFailError(this->failure.summary());
+                }
+            #endif
+        }
+
+        #if defined(CXXSPEC_HAS_EXCEPTIONS)
         template<typename T>
         void expect_throw(ExBlock block) {
             try {
@@ -108,56 +403,94 @@ namespace cxxspec {
             catch (...) {
                 std::stringstream ss;
                 ss << "Expected to throw a " << util::demangle(typeid(T).name()) << ", but did throw a " << util::current_exception_typename() << " instead";
-                throw ExpectFailError(ss.str());
+                failExpectation(ss.str(), &this->failure);
+                return;
             }
 
             std::stringstream ss;
             ss << "Expected to throw a " << util::demangle(typeid(T).name()) << ", but didn't";
-            throw ExpectFailError(ss.str());
+            failExpectation(ss.str(), &this->failure);
         }
 
         void expect_no_throw(ExBlock block);
+        #endif
 
     private:
-        std::string _name;
-        std::string _sourcefile = "unknown";
+        // interned, as the same names (and especially sourcefiles) tend to repeat a lot
+        const std::string* _name;
+        const std::string* _sourcefile;
+        mutable std::once_flag fullnameOnce;
+        mutable std::unique_ptr<std::string> _fullname;
         Block block;
+        AsyncBlock asyncBlock;
         std::vector<CleanupBlock> cleanupBlocks;
+        // guarded by a mutex shared by all examples, as they're only touched by fixtures & timeouts
+        std::vector<CleanupBlock> abandonBlocks;
+        // only allocated once the first value is memoized
+        std::unique_ptr<std::unordered_map<const void*, std::shared_ptr<void>>> memos;
+        // written by the expectations of the current execution
+        FailureRecord failure;
         DescribeAble* parent;
+        ExampleResult _result;
+        bool selected = true;
+        bool prioritized = false;
+        // set by the watchdog while the example still runs on another thread
+        std::atomic<bool> abandoned { false };
+        bool _aggregateFailures = false;
+        ExampleDuration _timeout = ExampleDuration::zero();
     };
 
+    /**
+     * Result of examples that weren't run because an around_each hook didn't call it's continuation
+     */
+    ExampleResult aroundEachSkippedResult();
+
     class Spec : public DescribeAble {
+        // narrows selections of whole subtrees at once
+        friend class Selector;
+
     public:
         typedef std::function<void (Spec&)> Block;
         typedef std::function<void()> SpecHookBlock;
         typedef std::function<void (Example&)> ExampleHookBlock;
+        typedef std::function<bool (const Example&)> ExampleFilter;
+        typedef std::vector<const ExampleHookBlock*> HookChain;
+        typedef std::function<void()> Continuation;
+        typedef std::function<void (const Continuation&)> AroundAllBlock;
+        typedef std::function<void (Example&, const Continuation&)> AroundEachBlock;
         enum HookType {
             HOOK_BEFORE,
             HOOK_AFTER,
         };
 
-        Spec(std::string desc, Block block, DescribeAble* parent = nullptr)
-            : _desc(desc), block(block), parent(parent)
-        {}
+        Spec(const std::string& desc, Block block, DescribeAble* parent = nullptr);
+        Spec(Spec&& other) noexcept;
+        Spec& operator=(Spec&& other) noexcept;
+        ~Spec();
 
-        inline void _context(std::string name, Block block) {
-            this->subspecs.push_back(Spec(name, block, this));
+        inline void _context(const std::string& name, Block block) {
+            Spec* spec = this->tree().specs.create(name, block, this);
+            spec->parentSpec = this;
+            spec->_tree = this->_tree;
+            this->subspecs.push_back(spec);
         }
 
-        inline void _it(std::string name, Example::Block block) {
-            this->examples.push_back(Example(name, block, this));
+        inline Example& _it(const std::string& name, Example::Block block) {
+            this->examples.push_back(this->tree().examples.create(name, block, this));
+            return *this->examples.back();
         }
 
-        inline void _it(std::string name, std::string sourcefile, Example::Block block) {
-            this->examples.push_back(Example(name, sourcefile, block, this));
+        inline Example& _it(const std::string& name, const std::string& sourcefile, Example::Block block) {
+            this->examples.push_back(this->tree().examples.create(name, sourcefile, block, this));
+            return *this->examples.back();
         }
 
-        inline void _it(const char* name, Example::Block block) {
-            this->_it(std::string(name), block);
+        inline Example& _it(const char* name, Example::Block block) {
+            return this->_it(std::string(name), block);
         }
 
-        inline void _it(const char* name, const char* sourcefile, Example::Block block) {
-            this->_it(std::string(name), std::string(sourcefile), block);
+        inline Example& _it(const char* name, const char* sourcefile, Example::Block block) {
+            return this->_it(std::string(name), std::string(sourcefile), block);
         }
 
         inline void _add_spec_hook(HookType type, SpecHookBlock block) {
@@ -168,29 +501,187 @@ namespace cxxspec {
             this->example_hooks.push_back(std::make_pair(type, block));
         }
 
+        /**
+         * Adds a hook wrapping the whole spec, including it's before_all & after_all hooks; it has to call the continuation once
+         */
+        inline void _add_around_all_hook(AroundAllBlock block) {
+            this->around_all_hooks.push_back(block);
+        }
+
+        /**
+         * Adds a hook wrapping every example, including it's before_each & after_each hooks; it has to call the continuation once
+         */
+        inline void _add_around_each_hook(AroundEachBlock block) {
+            this->around_each_hooks.push_back(block);
+        }
+
+        /**
+         * Runs the body inside of all around_all hooks of this spec (not of it's parents; they're wrapping this spec already)
+         *
+         * @return false if a hook didn't call the continuation
+         */
+        bool run_around_all_hooks(const Continuation& body);
+
+        /**
+         * Runs the body inside of all around_each hooks of this spec and it's parents, outermost first
+         *
+         * @return false if a hook didn't call the continuation
+         */
+        bool run_around_each_hooks(Example& ex, const Continuation& body);
+
+        /**
+         * Runs the example together with it's before_each, after_each & around_each hooks (of this spec and it's parents)
+         * and returns the outcome; the example fails if one of the hooks throws. With a watchdog all of it runs on the
+         * watchdog's executor thread, so the example is failed once it exceeds it's timeout and the hooks run on the same
+         * thread as the example.
+         */
+        ExampleResult executeExample(Example& ex, Watchdog* watchdog);
+
+        /**
+         * Runs the before_all hooks (inside of the around_all hooks) without running anything else; used by workers that
+         * run the examples of the spec one by one. As around_all hooks can only continue once their examples are done,
+         * they are suspended on a thread of their own until `leave()`.
+         *
+         * @throws whatever a hook threw, or std::runtime_error if an around_all hook didn't call the continuation
+         */
+        void enter();
+
+        /**
+         * Runs the after_all hooks and completes the around_all hooks; counterpart of `enter()`
+         */
+        void leave();
+
         void run_spec_hooks(HookType type);
 
         void run_example_hooks(HookType type, Example& ex);
 
+        /**
+         * Runs the block of the spec (once) to define it's subspecs, examples & hooks, and resolves the hook chains
+         */
         void defineChilds();
 
-        void run(Formatter& formatter, bool hasNextSpec);
+        /**
+         * Defines the whole subtree and narrows the selection of it's examples down to the ones accepted by the filter.
+         * Specs left without any selected example are skipped entirely when running, including their hooks.
+         *
+         * @return number of examples in this subtree that are still selected
+         */
+        std::size_t selectExamples(const ExampleFilter& filter);
+
+        bool isSelected() const {
+            return !this->filtered || this->selectedCount > 0;
+        }
+
+        /**
+         * Turns the marks set via `mark()` into a selection: only examples inside marked specs stay selected.
+         * Unmarked subtrees are deselected without being defined.
+         *
+         * @return number of examples in this subtree that are still selected
+         */
+        std::size_t selectMarked();
+
+        /**
+         * Deselects the whole subtree without defining it
+         */
+        void deselect() {
+            this->filtered = true;
+            this->selectedCount = 0;
+        }
+
+        /**
+         * Narrows the selection to the paths in the given index node, which must be the node matching this spec.
+         * Only specs that are part of the index are defined.
+         *
+         * @return number of examples in this subtree that are still selected
+         */
+        std::size_t selectIndexed(const PathIndex::Node& node);
+
+        /**
+         * Prioritizes the examples in the given index node (and the specs leading to them), so they run first.
+         * Only specs that are part of the index are defined.
+         *
+         * @return true if anything in this subtree was prioritized
+         */
+        bool prioritize(const PathIndex::Node& node);
+
+        bool isPrioritized() const {
+            return this->prioritized;
+        }
+
+        /**
+         * Selected subspecs & examples in the order they are run: prioritized ones first, otherwise in definition order
+         */
+        std::vector<Spec*> selectedSubSpecs();
+        std::vector<Example*> selectedExamples();
+
+        /**
+         * Runs the selected part of this spec. Once the budget (if any) is exhausted, the remaining examples
+         * are reported as skipped; hooks of specs that are skipped entirely are not run.
+         * With a watchdog, examples that exceed their timeout are failed.
+         */
+        void run(Formatter& formatter, bool hasNextSpec, FailureBudget* budget = nullptr, Watchdog* watchdog = nullptr);
 
         void runMarkedOnly(Formatter& formatter, bool hasNextSpec);
 
-        std::vector<Spec>& getSubSpecs() {
+        const std::vector<Spec*>& getSubSpecs() const {
             return this->subspecs;
         }
 
-        std::string fulldesc() const {
-            if (this->parent == nullptr) {
-                return this->_desc;
+        const std::vector<Example*>& getExamples() const {
+            return this->examples;
+        }
+
+        const std::vector<std::pair<HookType, ExampleHookBlock>>& getExampleHooks() const {
+            return this->example_hooks;
+        }
+
+        /**
+         * All before_each or after_each hooks of this spec and it's parents, outermost first; resolved once the spec is defined
+         */
+        const HookChain& getHookChain(HookType type) const {
+            return type == HOOK_BEFORE ? this->beforeEachChain : this->afterEachChain;
+        }
+
+        const std::string& fulldesc() const {
+            return *this->_fulldesc;
+        }
+
+        const std::string& desc() const {
+            return *this->_desc;
+        }
+
+        /**
+         * Time each example inside of this spec is allowed to take; inherited from the parent if not set
+         */
+        ExampleDuration timeout() const {
+            if (this->_timeout > ExampleDuration::zero() || this->parent == nullptr) {
+                return this->_timeout;
             }
-            return this->parent->fulldesc() + " " + this->_desc;
+            return this->parent->timeout();
         }
 
-        std::string desc() const {
-            return this->_desc;
+        void setTimeout(ExampleDuration timeout) {
+            this->_timeout = timeout;
+        }
+
+        /**
+         * Whether the examples inside of this spec aggregate their failures; inherited from the parent if not set
+         */
+        bool aggregatesFailures() const {
+            return this->_aggregateFailures || (this->parent != nullptr && this->parent->aggregatesFailures());
+        }
+
+        void setAggregateFailures(bool aggregate) {
+            this->_aggregateFailures = aggregate;
+        }
+
+        std::vector<std::string> path() const {
+            if (this->parent == nullptr) {
+                return std::vector<std::string>{ *this->_desc };
+            }
+            std::vector<std::string> list = this->parent->path();
+            list.push_back(*this->_desc);
+            return list;
         }
 
         int getRuns() const {
@@ -214,16 +705,68 @@ namespace cxxspec {
         }
 
     private:
-        std::string _desc;
+        void skip(Formatter& formatter, bool hasNextSpec, const ExampleResult& result);
+
+        /**
+         * Reports every selected example of the spec & it's subspecs with the given result, without running any hooks
+         */
+        void skipContents(Formatter& formatter, const ExampleResult& result, FailureBudget* budget);
+
+        /**
+         * Runs the subspecs & examples; the part of `run()` inside of the before_all & after_all hooks
+         */
+        void runContents(Formatter& formatter, FailureBudget* budget, Watchdog* watchdog);
+
+        /**
+         * Runs all asynchronous examples out of the given ones interleaved on a single event loop, up to the point
+         * where they are reported; their `before_each` hooks run upfront.
+         *
+         * @return which of the examples did run
+         */
+        std::vector<bool> runAsync(const std::vector<Example*>& examples, Watchdog* watchdog);
+
+        /**
+         * Storage of all specs & examples below the top-level spec; created by the top-level spec on first use
+         */
+        struct Tree {
+            Arena<Spec> specs;
+            Arena<Example> examples;
+        };
+
+        Tree& tree();
+
+        // around_all hooks suspended by `enter()`
+        struct Scope;
+
+        // the description is interned, as it repeats across reloads; the full description is unique to the spec,
+        // so it's owned by it and built once, when the spec is created
+        const std::string* _desc;
+        std::unique_ptr<std::string> _fulldesc;
         Block block;
         int runs = 0;
         bool marked = false; bool markedSubSpecs = false;
         bool defined = false;
-
-        std::vector<Spec> subspecs;
-        std::vector<Example> examples;
+        bool filtered = false;
+        std::size_t selectedCount = 0;
+        bool prioritized = false;
+        bool _aggregateFailures = false;
+        ExampleDuration _timeout = ExampleDuration::zero();
+
+        std::vector<Spec*> subspecs;
+        std::vector<Example*> examples;
+        // owned by the top-level spec only
+        std::unique_ptr<Tree> ownTree;
+        Tree* _tree = nullptr;
         std::vector<std::pair<HookType, SpecHookBlock>> spec_hooks;
         std::vector<std::pair<HookType, ExampleHookBlock>> example_hooks;
+        std::vector<AroundAllBlock> around_all_hooks;
+        std::vector<AroundEachBlock> around_each_hooks;
+        HookChain beforeEachChain;
+        HookChain afterEachChain;
+        std::vector<const AroundEachBlock*> aroundEachChain;
+        std::unique_ptr<Scope> scope;
+        // same as parent, but only set if the parent is a spec
+        Spec* parentSpec = nullptr;
 
         DescribeAble* parent;
     };
@@ -0,0 +1,235 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "./event_loop.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace cxxspec {
+
+    static thread_local EventLoop* currentLoop = nullptr;
+
+    EventLoop::EventLoop() {
+        this->epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (this->epollFd < 0) {
+            throw std::runtime_error(std::string("Could not create event loop: ") + std::strerror(errno));
+        }
+    }
+
+    EventLoop::~EventLoop() {
+        close(this->epollFd);
+    }
+
+    EventLoop* EventLoop::current() {
+        return currentLoop;
+    }
+
+    EventLoop::Handle EventLoop::add(Callback callback) {
+        Handle handle = ++this->lastHandle;
+        this->callbacks[handle] = std::move(callback);
+        return handle;
+    }
+
+    EventLoop::Handle EventLoop::post(Callback callback) {
+        Handle handle = this->add(std::move(callback));
+        this->ready.push_back(handle);
+        return handle;
+    }
+
+    EventLoop::Handle EventLoop::watch(int fd, Interest interest, Callback callback) {
+        FdState& state = this->fds[fd];
+        Handle& slot = interest == WAIT_READABLE ? state.readable : state.writable;
+        if (slot != 0) {
+            throw std::runtime_error("Fd " + std::to_string(fd) + " is already waited on for the same event");
+        }
+        Handle handle = this->add(std::move(callback));
+        slot = handle;
+        this->watches[handle] = fd;
+        this->update(fd);
+        return handle;
+    }
+
+    EventLoop::Handle EventLoop::after(ExampleDuration delay, Callback callback) {
+        Handle handle = this->add(std::move(callback));
+        this->timers.insert(std::make_pair(Clock::now() + delay, handle));
+        return handle;
+    }
+
+    void EventLoop::cancel(Handle handle) {
+        this->callbacks.erase(handle);
+
+        auto it = this->watches.find(handle);
+        if (it != this->watches.end()) {
+            int fd = it->second;
+            this->watches.erase(it);
+            FdState& state = this->fds[fd];
+            if (state.readable == handle) {
+                state.readable = 0;
+            }
+            if (state.writable == handle) {
+                state.writable = 0;
+            }
+            this->update(fd);
+        }
+        // cancelled timers and posts stay queued; they're dropped once they come up
+    }
+
+    void EventLoop::fire(Handle handle) {
+        auto it = this->callbacks.find(handle);
+        if (it == this->callbacks.end()) {
+            return;
+        }
+        // the callback may register or cancel other callbacks, so it's taken out of the map first
+        Callback callback = std::move(it->second);
+        this->callbacks.erase(it);
+        callback();
+    }
+
+    void EventLoop::update(int fd) {
+        auto it = this->fds.find(fd);
+        if (it == this->fds.end()) {
+            return;
+        }
+        FdState& state = it->second;
+
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.data.fd = fd;
+        if (state.readable != 0) {
+            event.events |= EPOLLIN;
+        }
+        if (state.writable != 0) {
+            event.events |= EPOLLOUT;
+        }
+
+        if (event.events == 0) {
+            if (state.registered) {
+                epoll_ctl(this->epollFd, EPOLL_CTL_DEL, fd, nullptr);
+            }
+            this->fds.erase(it);
+            return;
+        }
+
+        int op = state.registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+        if (epoll_ctl(this->epollFd, op, fd, &event) == 0) {
+            state.registered = true;
+            return;
+        }
+
+        // regular files can't be watched, but never block either; everything else is reported to the waiting side as ready too,
+        // so the read or write it's about to do fails with the actual error
+        Handle readable = state.readable;
+        Handle writable = state.writable;
+        if (state.registered) {
+            epoll_ctl(this->epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        }
+        this->fds.erase(it);
+        for (Handle handle : { readable, writable }) {
+            if (handle != 0) {
+                this->watches.erase(handle);
+                this->ready.push_back(handle);
+            }
+        }
+    }
+
+    ExampleDuration::rep EventLoop::nextTimeout() {
+        while (!this->timers.empty() && this->callbacks.count(this->timers.begin()->second) == 0) {
+            this->timers.erase(this->timers.begin());
+        }
+        if (this->timers.empty()) {
+            return -1;
+        }
+        ExampleDuration remaining = this->timers.begin()->first - Clock::now();
+        if (remaining <= ExampleDuration::zero()) {
+            return 0;
+        }
+        // rounded up, so a timer never fires early
+        return std::chrono::duration_cast<std::chrono::milliseconds>(remaining + std::chrono::milliseconds(1) - ExampleDuration(1)).count();
+    }
+
+    void EventLoop::dispatchTimers() {
+        Clock::time_point now = Clock::now();
+        while (!this->timers.empty() && this->timers.begin()->first <= now) {
+            this->ready.push_back(this->timers.begin()->second);
+            this->timers.erase(this->timers.begin());
+        }
+    }
+
+    void EventLoop::run(const std::function<bool()>& done) {
+        struct Current {
+            EventLoop* previous;
+            Current(EventLoop* loop) : previous(currentLoop) { currentLoop = loop; }
+            ~Current() { currentLoop = this->previous; }
+        } current(this);
+
+        epoll_event events[64];
+        while (!done()) {
+            if (!this->ready.empty()) {
+                // only what's ready now; callbacks posted meanwhile run on the next iteration, after fds & timers got a chance
+                std::deque<Handle> batch;
+                batch.swap(this->ready);
+                for (Handle handle : batch) {
+                    this->fire(handle);
+                }
+                this->dispatchTimers();
+                continue;
+            }
+
+            ExampleDuration::rep timeout = this->nextTimeout();
+            if (timeout < 0 && this->fds.empty()) {
+                // nothing could ever wake us up again
+                return;
+            }
+
+            int count = epoll_wait(this->epollFd, events, sizeof(events) / sizeof(events[0]), (int) timeout);
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::string("Event loop failed: ") + std::strerror(errno));
+            }
+
+            for (int i = 0; i < count; i++) {
+                auto it = this->fds.find(events[i].data.fd);
+                if (it == this->fds.end()) {
+                    continue;
+                }
+                FdState& state = it->second;
+                std::uint32_t failed = events[i].events & (EPOLLERR | EPOLLHUP);
+                if (state.readable != 0 && (events[i].events & (EPOLLIN | failed))) {
+                    this->watches.erase(state.readable);
+                    this->ready.push_back(state.readable);
+                    state.readable = 0;
+                }
+                if (state.writable != 0 && (events[i].events & (EPOLLOUT | failed))) {
+                    this->watches.erase(state.writable);
+                    this->ready.push_back(state.writable);
+                    state.writable = 0;
+                }
+                this->update(events[i].data.fd);
+            }
+            this->dispatchTimers();
+        }
+    }
+
+}
\ No newline at end of file
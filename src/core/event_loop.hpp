@@ -0,0 +1,111 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./formatter.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <unordered_map>
+
+namespace cxxspec {
+
+    /**
+     * Single-threaded event loop driving asynchronous examples; built on epoll.
+     *
+     * Every registration (posted callback, fd watch or timer) fires at most once and is identified by a handle
+     * that can be used to cancel it. Callbacks always run from inside `run()`, never from the registering call.
+     */
+    class EventLoop {
+    public:
+        typedef std::function<void()> Callback;
+        typedef std::uint64_t Handle;
+        typedef std::chrono::steady_clock Clock;
+
+        enum Interest {
+            WAIT_READABLE,
+            WAIT_WRITABLE,
+        };
+
+        /**
+         * @throws std::runtime_error if no epoll instance could be created
+         */
+        EventLoop();
+        ~EventLoop();
+
+        EventLoop(const EventLoop&) = delete;
+        EventLoop& operator=(const EventLoop&) = delete;
+
+        /**
+         * Runs the callback on the next iteration of the loop
+         */
+        Handle post(Callback callback);
+
+        /**
+         * Runs the callback once the fd becomes readable or writable; errors and hangups count as both.
+         * Fds epoll can't watch (like regular files) are always ready.
+         */
+        Handle watch(int fd, Interest interest, Callback callback);
+
+        /**
+         * Runs the callback once the delay passed
+         */
+        Handle after(ExampleDuration delay, Callback callback);
+
+        /**
+         * Forgets a registration; does nothing if it already fired or was cancelled
+         */
+        void cancel(Handle handle);
+
+        /**
+         * Runs callbacks until `done` returns true or there is nothing left to wait for
+         */
+        void run(const std::function<bool()>& done);
+
+        /**
+         * The loop currently running on this thread, if any
+         */
+        static EventLoop* current();
+
+    private:
+        struct FdState {
+            Handle readable = 0;
+            Handle writable = 0;
+            bool registered = false;
+        };
+
+        Handle add(Callback callback);
+        void fire(Handle handle);
+        void update(int fd);
+        ExampleDuration::rep nextTimeout();
+        void dispatchTimers();
+
+        int epollFd;
+        Handle lastHandle = 0;
+        std::unordered_map<Handle, Callback> callbacks;
+        std::deque<Handle> ready;
+        std::multimap<Clock::time_point, Handle> timers;
+        std::unordered_map<int, FdState> fds;
+        std::unordered_map<Handle, int> watches;
+    };
+
+}
\ No newline at end of file
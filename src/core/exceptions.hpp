@@ -21,6 +21,18 @@
 #include <string>
 #include <stdexcept>
 #include <sstream>
+#include <cstdlib>
+#include <iostream>
+
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+    #define CXXSPEC_HAS_EXCEPTIONS 1
+#endif
+
+// failed expectations are recorded in their example instead of being thrown; the only way without exceptions.
+// Must be the same for all spec sources of a binary, the library itself handles both.
+#if !defined(CXXSPEC_HAS_EXCEPTIONS) && !defined(CXXSPEC_FAILURE_RECORDS)
+    #define CXXSPEC_FAILURE_RECORDS 1
+#endif
 
 namespace cxxspec {
 
@@ -29,6 +41,107 @@ namespace cxxspec {
         ExpectFailError(std::string msg) : std::runtime_error(msg) {}
     };
 
+    /**
+     * Failed expectations of an example; filled instead of throwing an `ExpectFailError` with `CXXSPEC_FAILURE_RECORDS`
+     * or while failures are aggregated. Otherwise only the first failure is kept, aggregating keeps all of them up to
+     * `maxReasons` / `maxReasonBytes`; the ones after that are only counted.
+     */
+    struct FailureRecord {
+        static constexpr std::size_t maxReasons = 100;
+        static constexpr std::size_t maxReasonBytes = 64 * 1024;
+
+        bool failed = false;
+        // reason of the first failure
+        std::string reason;
+        // number of failures; only more than one while aggregating
+        std::size_t failures = 0;
+        // depth of `aggregate_failures` blocks (plus one if the whole example aggregates)
+        unsigned aggregating = 0;
+
+        /**
+         * Whether failed expectations are recorded here instead of being thrown
+         */
+        bool isRecording() const {
+            #if defined(CXXSPEC_FAILURE_RECORDS)
+                return true;
+            #else
+                return this->aggregating > 0;
+            #endif
+        }
+
+        /**
+         * Whether the outcome is decided already: the example failed and isn't aggregating, so only the first failure
+         * is reported and further expectations don't need to be checked
+         */
+        bool isDecided() const {
+            return this->failed && this->aggregating == 0;
+        }
+
+        /**
+         * Whether the reason of the next failure would be kept; building it can be skipped otherwise
+         */
+        bool wantsReason() const {
+            if (!this->failed) {
+                return true;
+            }
+            return this->aggregating > 0 && this->stored < maxReasons && this->reason.size() + this->more.size() < maxReasonBytes;
+        }
+
+        void fail(std::string reason) {
+            if (this->failed && this->aggregating == 0) {
+                return;
+            }
+            this->failures++;
+            if (!this->failed) {
+                this->failed = true;
+                this->reason = std::move(reason);
+                this->stored = 1;
+            }
+            else if (this->stored < maxReasons && this->reason.size() + this->more.size() < maxReasonBytes) {
+                // all further reasons share a single buffer
+                this->stored++;
+                this->more.append("\n  ").append(std::to_string(this->stored)).append(") ").append(reason);
+            }
+        }
+
+        /**
+         * Reason to report: the only failure as it is, or all of them numbered
+         */
+        std::string summary() const {
+            if (this->failures <= 1) {
+                return this->reason;
+            }
+            std::string str = "Got " + std::to_string(this->failures) + " failures:\n  1) " + this->reason + this->more;
+            if (this->failures > this->stored) {
+                str += "\n  ... and " + std::to_string(this->failures - this->stored) + " more";
+            }
+            return str;
+        }
+
+    private:
+        // numbered reasons of the failures after the first one
+        std::string more;
+        std::size_t stored = 0;
+    };
+
+    /**
+     * Fails the current example: records the failure if the record (if any) is recording, otherwise throws an
+     * `ExpectFailError`. Without exceptions there is no way to fail it from outside of an expectation, so the
+     * process is aborted instead.
+     */
+    inline void failExpectation(const std::string& reason, FailureRecord* record = nullptr) {
+        if (record != nullptr && record->isRecording()) {
+            record->fail(reason);
+            return;
+        }
+        #if defined(CXXSPEC_HAS_EXCEPTIONS)
+            throw ExpectFailError(reason);
+        #else
+            std::cerr << "Expectation failed outside of an example: " << reason << std::endl;
+            std::abort();
+        #endif
+    }
+
     class ExpectationFailException : public std::runtime_error {
     public:
         ExpectationFailException(std::string msg)
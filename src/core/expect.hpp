@@ -29,28 +29,32 @@ namespace cxxspec {
     template<typename T_got>
     class Expectation {
     public:
-        Expectation(const T_got& got)
-            : got(got)
+        /**
+         * @param record  failure record of the example the expectation belongs to; failures are only recorded
+         *                there with `CXXSPEC_FAILURE_RECORDS`
+         */
+        Expectation(const T_got& got, FailureRecord* record = nullptr)
+            : got(got), record(record)
         {}
 
         void to(Matcher<T_got>&& matcher) {
             matcher.is_negative = false;
-            matcher.run(this->got);
+            matcher.run(this->got, this->record);
         }
 
         void to_not(Matcher<T_got>&& matcher) {
             matcher.is_negative = true;
-            matcher.run(this->got);
+            matcher.run(this->got, this->record);
         }
 
         #define COMPARE_MATCHER(name, clazz) \
-            template<typename T_expected> void to_##name(T_expected& expected_value) { clazz<T_got, T_expected>(expected_value).run(this->got); } \
-            template<typename T_expected> void to_##name(T_expected&& expected_value) { clazz<T_got, T_expected>(util::unmove(expected_value)).run(this->got); } \
+            template<typename T_expected> void to_##name(T_expected& expected_value) { clazz<T_got, T_expected>(expected_value).run(this->got, this->record); } \
+            template<typename T_expected> void to_##name(T_expected&& expected_value) { clazz<T_got, T_expected>(util::unmove(expected_value)).run(this->got, this->record); } \
             template<typename T_expected> void to_not_##name(T_expected& expected_value) { \
-                auto m = clazz<T_got, T_expected>(expected_value); m.is_negative = true; m.run(this->got); \
+                auto m = clazz<T_got, T_expected>(expected_value); m.is_negative = true; m.run(this->got, this->record); \
             } \
             template<typename T_expected> void to_not_##name(T_expected&& expected_value) { \
-                auto m = clazz<T_got, T_expected>(util::unmove(expected_value)); m.is_negative = true; m.run(this->got); \
+                auto m = clazz<T_got, T_expected>(util::unmove(expected_value)); m.is_negative = true; m.run(this->got, this->record); \
             }
 
         // ---------- eq <value> ----------
@@ -81,14 +85,14 @@ namespace cxxspec {
 
         template<typename T_expected>
         void to_contain(T_expected expected_value) {
-            matchers::IncludeMatcher<T_got, T_expected>(expected_value).run(this->got);
+            matchers::IncludeMatcher<T_got, T_expected>(expected_value).run(this->got, this->record);
         }
 
         template<typename T_expected>
         void to_not_contain(T_expected expected_value) {
             auto m = matchers::IncludeMatcher<T_got, T_expected>(expected_value);
             m.is_negative = true;
-            m.run(this->got);
+            m.run(this->got, this->record);
         }
 
         // ---------- be <value> ----------
@@ -99,56 +103,57 @@ namespace cxxspec {
 
         template<typename T_expected>
         void to_be_a() {
-            matchers::BeAMatcher<T_got, T_expected>().run(this->got);
+            matchers::BeAMatcher<T_got, T_expected>().run(this->got, this->record);
         }
 
         template<typename T_expected>
         void to_not_be_a() {
             auto m = matchers::BeAMatcher<T_got, T_expected>();
             m.is_negative = true;
-            m.run(this->got);
+            m.run(this->got, this->record);
         }
 
         // ---------- match <regex> ----------
 
         void to_match(std::string& regex_str) {
-            matchers::RegexMatcher<T_got>(regex_str).run(this->got);
+            matchers::RegexMatcher<T_got>(regex_str).run(this->got, this->record);
         }
 
         void to_match(std::string& regex_str,
                         std::regex_constants::match_flag_type match_flags,
                         std::regex_constants::syntax_option_type regex_flags = std::regex_constants::ECMAScript
         ) {
-            matchers::RegexMatcher<T_got>(regex_str, match_flags, regex_flags).run(this->got);
+            matchers::RegexMatcher<T_got>(regex_str, match_flags, regex_flags).run(this->got, this->record);
         }
 
         void to_match(std::string& regex_str,
                         std::regex_constants::syntax_option_type regex_flags,
                         std::regex_constants::match_flag_type match_flags = std::regex_constants::match_default
         ) {
-            matchers::RegexMatcher<T_got>(regex_str, regex_flags, match_flags).run(this->got);
+            matchers::RegexMatcher<T_got>(regex_str, regex_flags, match_flags).run(this->got, this->record);
         }
 
         void to_match(std::string&& regex_str) {
-            matchers::RegexMatcher<T_got>(util::unmove(regex_str)).run(this->got);
+            matchers::RegexMatcher<T_got>(util::unmove(regex_str)).run(this->got, this->record);
         }
 
         void to_match(std::string&& regex_str,
                         std::regex_constants::match_flag_type match_flags,
                         std::regex_constants::syntax_option_type regex_flags = std::regex_constants::ECMAScript
         ) {
-            matchers::RegexMatcher<T_got>(util::unmove(regex_str), match_flags, regex_flags).run(this->got);
+            matchers::RegexMatcher<T_got>(util::unmove(regex_str), match_flags, regex_flags).run(this->got, this->record);
         }
 
         void to_match(std::string&& regex_str,
                         std::regex_constants::syntax_option_type regex_flags,
                         std::regex_constants::match_flag_type match_flags = std::regex_constants::match_default
         ) {
-            matchers::RegexMatcher<T_got>(util::unmove(regex_str), regex_flags, match_flags).run(this->got);
+            matchers::RegexMatcher<T_got>(util::unmove(regex_str), regex_flags, match_flags).run(this->got, this->record);
         }
 
     private:
         const T_got& got;
+        FailureRecord* record;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,180 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "./fixture_pool.hpp"
+#include "./util.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+namespace cxxspec {
+
+    // never destroyed, as pools are static themselves and may be destroyed after it otherwise
+    static std::mutex& registryMutex() {
+        static std::mutex* mutex = new std::mutex();
+        return *mutex;
+    }
+
+    static std::vector<FixturePoolBase*>& registry() {
+        static std::vector<FixturePoolBase*>* pools = new std::vector<FixturePoolBase*>();
+        return *pools;
+    }
+
+    FixturePoolBase::FixturePoolBase(const std::string& name, std::size_t limit)
+        : _limit(limit > 0 ? limit : util::available_cpus())
+    {
+        this->_stats.name = name;
+
+        std::lock_guard<std::mutex> lock(registryMutex());
+        registry().push_back(this);
+    }
+
+    FixturePoolBase::~FixturePoolBase() {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        std::vector<FixturePoolBase*>& pools = registry();
+        pools.erase(std::remove(pools.begin(), pools.end(), this), pools.end());
+    }
+
+    FixturePoolStats FixturePoolBase::stats() const {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        return this->_stats;
+    }
+
+    std::vector<FixturePoolStats> FixturePoolBase::allStats() {
+        std::vector<FixturePoolStats> list;
+        std::lock_guard<std::mutex> lock(registryMutex());
+        for (FixturePoolBase* pool : registry()) {
+            FixturePoolStats stats = pool->stats();
+            if (stats.creations > 0 || stats.reuses > 0) {
+                list.push_back(stats);
+            }
+        }
+        return list;
+    }
+
+    void* FixturePoolBase::acquire() {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        if (this->idle.empty() && this->alive >= this->_limit) {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            this->cond.wait(lock, [this] () { return !this->idle.empty() || this->alive < this->_limit; });
+            this->_stats.waits++;
+            this->_stats.waitTime += std::chrono::steady_clock::now() - start;
+        }
+
+        if (!this->idle.empty()) {
+            // the instance this thread used last is likely still warm
+            std::thread::id self = std::this_thread::get_id();
+            auto it = std::find_if(this->idle.begin(), this->idle.end(), [&self] (const Idle& entry) { return entry.owner == self; });
+            if (it == this->idle.end()) {
+                it = this->idle.end() - 1;
+            }
+            void* instance = it->instance;
+            this->idle.erase(it);
+            this->_stats.reuses++;
+            return instance;
+        }
+
+        // the slot is taken before creating, so the pool never exceeds it's limit
+        this->alive++;
+        this->_stats.peak = std::max(this->_stats.peak, this->alive);
+        lock.unlock();
+
+        void* instance = nullptr;
+        try {
+            instance = this->create();
+        }
+        catch (...) {
+            lock.lock();
+            this->alive--;
+            lock.unlock();
+            this->cond.notify_one();
+            throw;
+        }
+
+        lock.lock();
+        this->_stats.creations++;
+        return instance;
+    }
+
+    void FixturePoolBase::release(void* instance) {
+        bool usable = true;
+        try {
+            this->reset(instance);
+        }
+        catch (...) {
+            usable = false;
+        }
+        if (!usable) {
+            this->destroy(instance);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if (usable) {
+                this->idle.push_back(Idle{ instance, std::this_thread::get_id() });
+            }
+            else {
+                this->alive--;
+            }
+        }
+        this->cond.notify_one();
+    }
+
+    void FixturePoolBase::abandon(void* instance) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->alive--;
+            this->_stats.abandoned++;
+        }
+        this->cond.notify_one();
+    }
+
+    void FixturePoolBase::clear() {
+        std::vector<Idle> list;
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            list.swap(this->idle);
+            this->alive -= list.size();
+        }
+        for (Idle& entry : list) {
+            this->destroy(entry.instance);
+        }
+    }
+
+    void printFixtureStats(std::ostream& stream) {
+        std::vector<FixturePoolStats> list = FixturePoolBase::allStats();
+        if (list.empty()) {
+            return;
+        }
+
+        stream << "Fixture pools:" << std::endl;
+        for (FixturePoolStats& stats : list) {
+            double waited = std::chrono::duration_cast<std::chrono::duration<double>>(stats.waitTime).count();
+            stream << "  " << stats.name << ": " << stats.creations << " created, " << stats.reuses << " reused, "
+                << stats.peak << " at most; waited " << stats.waits << " time(s) for "
+                << std::fixed << std::setprecision(3) << waited << "s";
+            if (stats.abandoned > 0) {
+                stream << "; " << stats.abandoned << " abandoned";
+            }
+            stream << std::endl;
+        }
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,205 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./core.hpp"
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cxxspec {
+
+    /**
+     * Counters of a fixture pool over the whole run
+     */
+    struct FixturePoolStats {
+        std::string name;
+        // instances created by the factory
+        std::size_t creations = 0;
+        // checkouts served by an instance that already existed
+        std::size_t reuses = 0;
+        // checkouts that had to wait for another example to return an instance
+        std::size_t waits = 0;
+        ExampleDuration waitTime = ExampleDuration::zero();
+        // most instances alive at the same time
+        std::size_t peak = 0;
+        // instances left to examples that were abandoned after a timeout; never reused nor destroyed
+        std::size_t abandoned = 0;
+    };
+
+    /**
+     * Type independent part of `FixturePool`: bookkeeping of the instances, waiting & statistics.
+     * Every pool registers itself, so the statistics of all pools can be reported after a run.
+     */
+    class FixturePoolBase {
+    public:
+        /**
+         * @param limit  most instances alive at the same time; 0 for the number of cpus available
+         */
+        FixturePoolBase(const std::string& name, std::size_t limit);
+        virtual ~FixturePoolBase();
+
+        FixturePoolBase(const FixturePoolBase&) = delete;
+        FixturePoolBase& operator=(const FixturePoolBase&) = delete;
+
+        FixturePoolStats stats() const;
+
+        std::size_t limit() const {
+            return this->_limit;
+        }
+
+        /**
+         * Statistics of all pools that were used at least once, in order of creation
+         */
+        static std::vector<FixturePoolStats> allStats();
+
+    protected:
+        /**
+         * Takes an idle instance (preferring the one this thread returned last), creates a new one if the pool
+         * isn't full yet or waits for one to be returned
+         */
+        void* acquire();
+
+        /**
+         * Resets the instance and makes it available again; instances failing to reset are destroyed
+         */
+        void release(void* instance);
+
+        /**
+         * Gives up on an instance that is checked out by an abandoned example: it's still in use, so it's neither
+         * reused nor destroyed, but no longer counts towards the limit either
+         */
+        void abandon(void* instance);
+
+        /**
+         * Destroys all idle instances; must be called by the destructor of the implementation
+         */
+        void clear();
+
+        virtual void* create() = 0;
+        virtual void reset(void* instance) = 0;
+        virtual void destroy(void* instance) = 0;
+
+    private:
+        struct Idle {
+            void* instance;
+            // thread that returned the instance
+            std::thread::id owner;
+        };
+
+        std::size_t _limit;
+        mutable std::mutex mutex;
+        std::condition_variable cond;
+        std::vector<Idle> idle;
+        std::size_t alive = 0;
+        FixturePoolStats _stats;
+    };
+
+    /**
+     * A bounded pool of expensive fixtures (servers, loaded indices, ...) shared by many examples. Every example
+     * checks out an instance for itself; it's reset and returned to the pool once the example and it's hooks are done.
+     * Instances stick to the worker thread that used them last, and with process isolation every worker process has a
+     * pool of it's own. An example abandoned after a timeout keeps it's instance, which is replaced by a new one.
+     *
+     * Pools are meant to be declared once, i.e. as static variables:
+     * ```c++
+     * static cxxspec::FixturePool<Server> servers("servers", [] { return new Server(); }, [] (Server& s) { s.clear(); });
+     * ```
+     */
+    template<typename T>
+    class FixturePool : public FixturePoolBase {
+    public:
+        typedef std::function<T* ()> Factory;
+        typedef std::function<void (T&)> Reset;
+
+        /**
+         * @param factory  creates a new instance; the pool takes ownership
+         * @param reset    brings a used instance back into a clean state before it's handed out again; optional
+         * @param limit    most instances alive at the same time; 0 for the number of cpus available
+         */
+        FixturePool(const std::string& name, Factory factory, Reset reset = Reset(), std::size_t limit = 0)
+            : FixturePoolBase(name, limit), factory(factory), resetter(reset)
+        {}
+
+        ~FixturePool() {
+            this->clear();
+        }
+
+        /**
+         * Instance for the example; checking out again during the same example returns the same instance
+         */
+        T& checkout(Example& example) {
+            return *example.memoize<Lease>(this, [this, &example] () {
+                Lease lease(*this);
+                void* instance = lease.instance;
+                example.onAbandon([this, instance] () { this->abandon(instance); });
+                return lease;
+            }).instance;
+        }
+
+    protected:
+        void* create() override {
+            return this->factory();
+        }
+
+        void reset(void* instance) override {
+            if (this->resetter) {
+                this->resetter(*static_cast<T*>(instance));
+            }
+        }
+
+        void destroy(void* instance) override {
+            delete static_cast<T*>(instance);
+        }
+
+    private:
+        // holds an instance until the example is done
+        struct Lease {
+            FixturePool* pool;
+            T* instance;
+
+            explicit Lease(FixturePool& pool) : pool(&pool), instance(static_cast<T*>(pool.acquire())) {}
+
+            Lease(Lease&& other) : pool(other.pool), instance(other.instance) {
+                other.instance = nullptr;
+            }
+
+            ~Lease() {
+                if (this->instance != nullptr) {
+                    this->pool->release(this->instance);
+                }
+            }
+        };
+
+        Factory factory;
+        Reset resetter;
+    };
+
+    /**
+     * Writes the statistics of all pools that were used; writes nothing if none were
+     */
+    void printFixtureStats(std::ostream& stream);
+
+}
\ No newline at end of file
@@ -48,6 +48,9 @@ namespace cxxspec {
         virtual void onExampleResult(Example& example, bool result, std::string reason, ExampleDuration timeTaken) = 0;
         virtual void onLeaveExample(Example& example, bool hasNextElement) = 0;
 
+        // called instead of onExampleResult for examples that were not executed (i.e. after reaching the failure limit)
+        virtual void onExampleSkipped(Example& example, std::string reason) {}
+
         //virtual void onExpectationFail(ExpectationFailException& ex) = 0;
     };
 
@@ -0,0 +1,205 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "./history.hpp"
+#include "./util.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+
+namespace cxxspec {
+
+    static const char historyMagic[8] = { 'C', 'X', 'S', 'P', 'H', 'I', 'S', '1' };
+
+    struct HistoryRecord {
+        std::uint64_t key;
+        std::int64_t nanoseconds;
+    };
+
+    // every segment is prefixed with it's length, so no two paths share a key (unlike joined names: "a b" / "c" & "a" / "b c")
+    static std::uint64_t historyKey(const std::vector<std::string>& path) {
+        std::string buf;
+        for (const std::string& segment : path) {
+            buf.append(std::to_string(segment.size()));
+            buf.push_back(':');
+            buf.append(segment);
+        }
+        return util::stable_hash(buf);
+    }
+
+    void DurationHistory::load(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return;
+        }
+
+        char magic[sizeof(historyMagic)];
+        std::uint64_t count = 0;
+        if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, historyMagic, sizeof(magic)) != 0
+            || !file.read(reinterpret_cast<char*>(&count), sizeof(count))
+        ) {
+            throw std::runtime_error("Not a duration history: " + path);
+        }
+
+        std::vector<HistoryRecord> records(count);
+        if (count > 0 && !file.read(reinterpret_cast<char*>(records.data()), count * sizeof(HistoryRecord))) {
+            throw std::runtime_error("Truncated duration history: " + path);
+        }
+
+        this->durations.reserve(this->durations.size() + count);
+        for (const HistoryRecord& record : records) {
+            this->durations[record.key] = record.nanoseconds;
+        }
+    }
+
+    void DurationHistory::save(const std::string& path) const {
+        std::vector<HistoryRecord> records;
+        records.reserve(this->seen.size());
+        for (auto& entry : this->durations) {
+            if (this->seen.count(entry.first) > 0) {
+                records.push_back(HistoryRecord{ entry.first, entry.second });
+            }
+        }
+        // sorted, so the same history always results in the same file
+        std::sort(records.begin(), records.end(), [] (const HistoryRecord& a, const HistoryRecord& b) {
+            return a.key < b.key;
+        });
+
+        std::string tmp = path + ".tmp";
+        {
+            std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+            std::uint64_t count = records.size();
+            file.write(historyMagic, sizeof(historyMagic));
+            file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(HistoryRecord));
+            if (!file) {
+                throw std::runtime_error("Could not write duration history: " + tmp);
+            }
+        }
+        if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+            throw std::runtime_error("Could not replace duration history: " + path);
+        }
+    }
+
+    std::string DurationHistory::digest() const {
+        std::vector<HistoryRecord> records;
+        records.reserve(this->durations.size());
+        for (auto& entry : this->durations) {
+            records.push_back(HistoryRecord{ entry.first, entry.second });
+        }
+        std::sort(records.begin(), records.end(), [] (const HistoryRecord& a, const HistoryRecord& b) {
+            return a.key < b.key;
+        });
+
+        // FNV-1a, like util::stable_hash
+        std::uint64_t hash = 0xcbf29ce484222325ULL;
+        for (const HistoryRecord& record : records) {
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&record);
+            for (std::size_t i = 0; i < sizeof(HistoryRecord); i++) {
+                hash ^= bytes[i];
+                hash *= 0x100000001b3ULL;
+            }
+        }
+
+        char buf[17];
+        std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(hash));
+        return buf;
+    }
+
+    void DurationHistory::record(const std::vector<std::string>& path, ExampleDuration duration) {
+        std::uint64_t key = historyKey(path);
+        this->seen.insert(key);
+        auto it = this->durations.find(key);
+        if (it == this->durations.end()) {
+            this->durations[key] = duration.count();
+        }
+        else {
+            it->second = (it->second + duration.count()) / 2;
+        }
+    }
+
+    void DurationHistory::keep(const std::vector<std::string>& path) {
+        this->seen.insert(historyKey(path));
+    }
+
+    bool DurationHistory::lookup(const std::vector<std::string>& path, ExampleDuration& duration) const {
+        auto it = this->durations.find(historyKey(path));
+        if (it == this->durations.end()) {
+            return false;
+        }
+        duration = ExampleDuration(it->second);
+        return true;
+    }
+
+    std::vector<ExampleDuration> DurationHistory::predict(const std::vector<std::vector<std::string>>& paths, ExampleDuration fallback) const {
+        std::vector<ExampleDuration> expected(paths.size(), ExampleDuration::zero());
+        std::vector<bool> known(paths.size(), false);
+        std::vector<ExampleDuration> samples;
+
+        for (std::size_t i = 0; i < paths.size(); i++) {
+            if (this->lookup(paths[i], expected[i])) {
+                known[i] = true;
+                samples.push_back(expected[i]);
+            }
+        }
+
+        if (!samples.empty()) {
+            std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+            fallback = samples[samples.size() / 2];
+        }
+        for (std::size_t i = 0; i < paths.size(); i++) {
+            if (!known[i]) {
+                expected[i] = fallback;
+            }
+        }
+        return expected;
+    }
+
+    std::vector<unsigned> scheduleLongestFirst(const std::vector<ExampleDuration>& expected, unsigned bins) {
+        std::vector<std::size_t> order(expected.size());
+        for (std::size_t i = 0; i < order.size(); i++) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&expected] (std::size_t a, std::size_t b) {
+            return expected[a] > expected[b];
+        });
+
+        // min-heap of (load, bin)
+        typedef std::pair<ExampleDuration::rep, unsigned> Load;
+        std::priority_queue<Load, std::vector<Load>, std::greater<Load>> loads;
+        for (unsigned bin = 0; bin < bins; bin++) {
+            loads.push(Load(0, bin));
+        }
+
+        std::vector<unsigned> assignment(expected.size(), 0);
+        for (std::size_t job : order) {
+            Load least = loads.top();
+            loads.pop();
+            assignment[job] = least.second;
+            least.first += expected[job].count();
+            loads.push(least);
+        }
+        return assignment;
+    }
+
+}
\ No newline at end of file
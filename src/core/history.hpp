@@ -0,0 +1,94 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./formatter.hpp"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace cxxspec {
+
+    /**
+     * Durations of previous runs, keyed by the stable hash of the path of each example (see `Example::path()`).
+     * Only the examples seen by the current run are saved, so removed or renamed examples don't pile up.
+     *
+     * On disk this is a small binary file: a magic, the number of records and then one
+     * `(uint64 key, int64 nanoseconds)` pair per example.
+     */
+    class DurationHistory {
+    public:
+        /**
+         * Loads the history from a file; a missing file is treated as an empty history
+         *
+         * @throws std::runtime_error if the file exists but isn't a valid history
+         */
+        void load(const std::string& path);
+
+        /**
+         * Writes the durations of the examples recorded or kept since loading to a file; the file is replaced atomically
+         */
+        void save(const std::string& path) const;
+
+        /**
+         * Records a measured duration; older measurements are decayed instead of replaced, so a single outlier
+         * doesn't turn the schedule upside down
+         */
+        void record(const std::vector<std::string>& path, ExampleDuration duration);
+
+        /**
+         * Keeps the duration of an example that was seen but not measured (i.e. skipped) when saving
+         */
+        void keep(const std::vector<std::string>& path);
+
+        bool lookup(const std::vector<std::string>& path, ExampleDuration& duration) const;
+
+        /**
+         * Expected durations for the given examples. Examples without history are expected to take as long as the
+         * median of the known ones, or `fallback` if none are known at all.
+         */
+        std::vector<ExampleDuration> predict(const std::vector<std::vector<std::string>>& paths, ExampleDuration fallback = ExampleDuration(1000000)) const;
+
+        bool empty() const {
+            return this->durations.empty();
+        }
+
+        /**
+         * Hex digest of all recorded durations; equal histories have equal digests, no matter how they were built
+         */
+        std::string digest() const;
+
+    private:
+        std::unordered_map<std::uint64_t, std::int64_t> durations;
+        // keys recorded or kept since loading
+        std::unordered_set<std::uint64_t> seen;
+    };
+
+    /**
+     * Distributes jobs with the given expected durations over `bins` bins using the longest-processing-time-first rule.
+     * Ties are broken by index, so the result is deterministic.
+     *
+     * @return the bin of every job
+     */
+    std::vector<unsigned> scheduleLongestFirst(const std::vector<ExampleDuration>& expected, unsigned bins);
+
+}
\ No newline at end of file
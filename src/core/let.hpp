@@ -0,0 +1,58 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./core.hpp"
+
+#include <type_traits>
+#include <utility>
+
+namespace cxxspec {
+
+    /**
+     * Value declared with `let`; computed on first access inside an example and memoized until the example's cleanup.
+     * A `Let` itself is stateless (all values live in the examples), so it's declared as static local of the spec block
+     * and shared between all examples, threads and runs.
+     */
+    template<typename Factory>
+    class Let {
+    public:
+        typedef typename std::decay<decltype(std::declval<Factory&>()(std::declval<Example&>()))>::type Value;
+
+        Let(const char* name, Factory factory) : _name(name), factory(factory) {}
+
+        Value& get(Example& example) const {
+            return example.memoize<Value>(this, [this, &example] () { return this->factory(example); });
+        }
+
+        const char* name() const {
+            return this->_name;
+        }
+
+    private:
+        const char* _name;
+        Factory factory;
+    };
+
+    template<typename Factory>
+    inline Let<Factory> makeLet(const char* name, Factory factory) {
+        return Let<Factory>(name, factory);
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "./listing.hpp"
+
+namespace cxxspec {
+
+    class Lister {
+    public:
+        Lister(std::ostream& stream, ListFormat format) : stream(stream), format(format) {}
+
+        void list(Spec& spec, const std::string& prefix) {
+            spec.defineChilds();
+            std::string path = prefix + spec.desc();
+
+            if (this->format == LIST_JSON) {
+                this->separate();
+                stream << "{\"type\": \"spec\", \"path\": ";
+                util::write_json_string(stream, path);
+                stream << ", \"desc\": ";
+                util::write_json_string(stream, spec.desc());
+                stream << "}";
+            }
+            else {
+                stream << path << "/\n";
+            }
+
+            for (Spec* sub : spec.selectedSubSpecs()) {
+                this->list(*sub, path + "/");
+            }
+            for (Example* ex : spec.selectedExamples()) {
+                if (this->format == LIST_JSON) {
+                    this->separate();
+                    stream << "{\"type\": \"example\", \"path\": ";
+                    util::write_json_string(stream, path + "/" + ex->name());
+                    stream << ", \"name\": ";
+                    util::write_json_string(stream, ex->name());
+                    stream << ", \"sourcefile\": ";
+                    util::write_json_string(stream, ex->sourcefile());
+                    stream << "}";
+                }
+                else {
+                    stream << path << '/' << ex->name() << '\t' << ex->sourcefile() << '\n';
+                }
+            }
+        }
+
+        void finish() {
+            if (this->format == LIST_JSON) {
+                stream << (this->first ? "[]\n" : "\n]\n");
+            }
+            stream.flush();
+        }
+
+    private:
+        void separate() {
+            stream << (this->first ? "[\n  " : ",\n  ");
+            this->first = false;
+        }
+
+        std::ostream& stream;
+        ListFormat format;
+        bool first = true;
+    };
+
+    void listSpecs(std::ostream& stream, const std::vector<Spec*>& specs, ListFormat format) {
+        Lister lister(stream, format);
+        for (Spec* spec : specs) {
+            lister.list(*spec, "");
+        }
+        lister.finish();
+    }
+
+}
\ No newline at end of file
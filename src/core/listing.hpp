@@ -0,0 +1,41 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./core.hpp"
+
+#include <ostream>
+#include <vector>
+
+namespace cxxspec {
+
+    enum ListFormat {
+        // one line per spec (ending in '/') and per example (followed by a tab and it's sourcefile)
+        LIST_TEXT,
+        // an array of objects, one per line
+        LIST_JSON,
+    };
+
+    /**
+     * Writes the paths of all selected specs & examples below the given specs, without running any hooks or examples.
+     * The specs are defined where needed.
+     */
+    void listSpecs(std::ostream& stream, const std::vector<Spec*>& specs, ListFormat format);
+
+}
\ No newline at end of file
@@ -44,7 +44,11 @@ namespace cxxspec {
 
         virtual bool match(const T& got) = 0;
 
-        void run(const T& got);
+        /**
+         * Fails the current example if `got` doesn't match (or does, if negated): by throwing an `ExpectFailError`,
+         * or by filling the record (if any) of the example when it's recording
+         */
+        void run(const T& got, FailureRecord* record = nullptr);
 
         virtual std::string reason(const T& got) = 0;
 
@@ -59,7 +63,11 @@ namespace cxxspec {
         match_impl(const X& got) {
             std::stringstream ss;
             ss << "Derived classes of Matcher<T> (T = " << util::demangle(typeid(T).name()) << ") needs to implement match(const T& got)";
-            throw std::runtime_error(ss.str());
+            #if defined(CXXSPEC_HAS_EXCEPTIONS)
+                throw std::runtime_error(ss.str());
+            #else
+                std::abort();
+            #endif
         }
 
         template< typename X = T>
@@ -71,19 +79,19 @@ namespace cxxspec {
     };
 
     template<typename T>
-    void Matcher<T>::run(const T& got) {
-        if (!this->is_negative) {
-            if (this->match(got)) {
-                return;
-            }
-            throw ExpectFailError( this->reason(got) );
+    void Matcher<T>::run(const T& got, FailureRecord* record) {
+        if (record != nullptr && record->isRecording() && record->isDecided()) {
+            return;
         }
-        else {
-            if (!this->match(got)) {
-                return;
-            }
-            throw ExpectFailError( this->reason(got) );
+        if (this->match(got) != this->is_negative) {
+            return;
         }
+        if (record != nullptr && record->isRecording()) {
+            // once the record is full, failures are only counted and their reasons never built
+            record->fail(record->wantsReason() ? this->reason(got) : std::string());
+            return;
+        }
+        failExpectation(this->reason(got));
     }
 
     template<typename T_got, typename T_expected = T_got>
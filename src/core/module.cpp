@@ -0,0 +1,167 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "./module.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <dlfcn.h>
+#include <elf.h>
+#include <unistd.h>
+
+namespace cxxspec {
+
+    template<typename Ehdr, typename Shdr>
+    static bool readSection(std::ifstream& file, const char* wanted, std::string& contents) {
+        Ehdr header;
+        if (!file.seekg(0) || !file.read(reinterpret_cast<char*>(&header), sizeof(header))
+            || header.e_shentsize != sizeof(Shdr) || header.e_shstrndx >= header.e_shnum
+        ) {
+            return false;
+        }
+
+        std::vector<Shdr> sections(header.e_shnum);
+        if (!file.seekg(header.e_shoff) || !file.read(reinterpret_cast<char*>(sections.data()), sections.size() * sizeof(Shdr))) {
+            return false;
+        }
+
+        const Shdr& strtab = sections[header.e_shstrndx];
+        std::string names(strtab.sh_size, '\0');
+        if (!file.seekg(strtab.sh_offset) || !file.read(&names[0], names.size())) {
+            return false;
+        }
+
+        for (const Shdr& section : sections) {
+            if (section.sh_name >= names.size() || std::strcmp(names.c_str() + section.sh_name, wanted) != 0) {
+                continue;
+            }
+            if (section.sh_type == SHT_NOBITS) {
+                return false;
+            }
+            contents.assign(section.sh_size, '\0');
+            return section.sh_size == 0 || (file.seekg(section.sh_offset) && file.read(&contents[0], contents.size()));
+        }
+        return false;
+    }
+
+    bool readModuleSpecNames(const std::string& path, std::vector<std::string>& names) {
+        std::ifstream file(path, std::ios::binary);
+        unsigned char ident[EI_NIDENT];
+        if (!file || !file.read(reinterpret_cast<char*>(ident), sizeof(ident)) || std::memcmp(ident, ELFMAG, SELFMAG) != 0) {
+            return false;
+        }
+
+        std::string contents;
+        bool found = ident[EI_CLASS] == ELFCLASS64
+            ? readSection<Elf64_Ehdr, Elf64_Shdr>(file, "cxxspec_names", contents)
+            : readSection<Elf32_Ehdr, Elf32_Shdr>(file, "cxxspec_names", contents);
+        if (!found) {
+            return false;
+        }
+
+        // zero-terminated names, one per describe
+        std::size_t start = 0;
+        while (start < contents.size()) {
+            std::size_t end = contents.find('\0', start);
+            if (end == std::string::npos) {
+                end = contents.size();
+            }
+            if (end > start) {
+                names.push_back(contents.substr(start, end - start));
+            }
+            start = end + 1;
+        }
+        return true;
+    }
+
+    void loadModule(const std::string& path) {
+        // without a slash dlopen would search the library path instead of the working directory
+        std::string file = path.find('/') == std::string::npos ? "./" + path : path;
+        if (dlopen(file.c_str(), RTLD_NOW | RTLD_LOCAL) == nullptr) {
+            const char* error = dlerror();
+            throw std::runtime_error("Could not load spec module " + path + ": " + (error != nullptr ? error : "unknown error"));
+        }
+    }
+
+    ReloadableModule::~ReloadableModule() {
+        this->unload();
+    }
+
+    // copies the module to a fresh temporary file; the caller removes it once it's loaded
+    static std::string copyModule(const std::string& path) {
+        const char* tmpdir = std::getenv("TMPDIR");
+        std::string name = std::string(tmpdir != nullptr && *tmpdir != '\0' ? tmpdir : "/tmp") + "/cxxspec-module-XXXXXX";
+        int fd = mkstemp(&name[0]);
+        if (fd < 0) {
+            throw std::runtime_error("Could not create a copy of spec module " + path + ": " + std::strerror(errno));
+        }
+        close(fd);
+
+        std::ifstream in(path, std::ios::binary);
+        std::ofstream out(name, std::ios::binary | std::ios::trunc);
+        if (!in || !(out << in.rdbuf()) || !out.flush()) {
+            unlink(name.c_str());
+            throw std::runtime_error("Could not copy spec module " + path);
+        }
+        return name;
+    }
+
+    void ReloadableModule::reload() {
+        this->unload();
+
+        std::vector<const SpecSection*> before;
+        for (const SpecSection* section = registeredSpecSections(); section != nullptr; section = section->next) {
+            before.push_back(section);
+        }
+
+        std::string copy = copyModule(this->_path);
+        this->handle = dlopen(copy.c_str(), RTLD_NOW | RTLD_LOCAL);
+        // stays mapped without the file
+        unlink(copy.c_str());
+        if (this->handle == nullptr) {
+            const char* error = dlerror();
+            throw std::runtime_error("Could not load spec module " + this->_path + ": " + (error != nullptr ? error : "unknown error"));
+        }
+
+        for (const SpecSection* section = registeredSpecSections(); section != nullptr; section = section->next) {
+            if (std::find(before.begin(), before.end(), section) == before.end()) {
+                this->sections.push_back(section);
+            }
+        }
+    }
+
+    void ReloadableModule::unload() {
+        if (this->handle == nullptr) {
+            return;
+        }
+        dlclose(this->handle);
+        this->handle = nullptr;
+
+        // modules with unique symbols stay loaded (and registered) after dlclose
+        for (const SpecSection* section : this->sections) {
+            unregisterSpecSection(section);
+        }
+        this->sections.clear();
+    }
+
+}
@@ -0,0 +1,85 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./registry.hpp"
+
+#include <string>
+#include <vector>
+
+namespace cxxspec {
+
+    /**
+     * Reads the names of the top-level specs of a spec module (a shared object with specs in it) from it's
+     * `cxxspec_names` section, without loading the module.
+     *
+     * @return false if the file isn't an ELF file or has no such section; the specs it defines are unknown then
+     */
+    bool readModuleSpecNames(const std::string& path, std::vector<std::string>& names);
+
+    /**
+     * Loads a spec module into the process; it's specs are added to `all_specs` by the next `loadSpecs()`.
+     * Modules are never unloaded, as the specs keep referring to their code.
+     *
+     * @throws std::runtime_error if the module can't be loaded
+     */
+    void loadModule(const std::string& path);
+
+    /**
+     * A spec module that can be replaced by a newer build of it while the process keeps running (for watch mode).
+     * Every load works on a private copy of the file, so the build can overwrite the module at any time and the
+     * dynamic loader never hands out the previous build again, even if that one couldn't be unloaded.
+     */
+    class ReloadableModule {
+    public:
+        explicit ReloadableModule(const std::string& path) : _path(path) {}
+        ~ReloadableModule();
+
+        ReloadableModule(const ReloadableModule&) = delete;
+        ReloadableModule& operator=(const ReloadableModule&) = delete;
+
+        /**
+         * Unloads the module (if loaded) and loads the current build of it; it's specs are added to `all_specs`
+         * by the next `loadSpecs()`. All specs of the previous build must have been removed from `all_specs` before.
+         *
+         * @throws std::runtime_error if the module can't be loaded; it's unloaded then
+         */
+        void reload();
+
+        /**
+         * Unloads the module; it's specs are gone from the spec sections even if the loader keeps it mapped
+         */
+        void unload();
+
+        bool isLoaded() const {
+            return this->handle != nullptr;
+        }
+
+        const std::string& path() const {
+            return this->_path;
+        }
+
+    private:
+        std::string _path;
+        void* handle = nullptr;
+        // sections registered by the module; only compared, as they are gone once the module is unloaded
+        std::vector<const SpecSection*> sections;
+    };
+
+}
@@ -0,0 +1,97 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "./module_watcher.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace cxxspec {
+
+    ModuleWatcher::ModuleWatcher(const std::vector<std::string>& paths) {
+        this->fd = inotify_init1(IN_CLOEXEC);
+        if (this->fd < 0) {
+            throw std::runtime_error(std::string("Could not initialize inotify: ") + std::strerror(errno));
+        }
+
+        for (const std::string& path : paths) {
+            std::size_t slash = path.rfind('/');
+            std::string dir = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+
+            // the same directory yields the same watch descriptor
+            int wd = inotify_add_watch(this->fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+            if (wd < 0) {
+                int error = errno;
+                close(this->fd);
+                throw std::runtime_error("Could not watch " + dir + ": " + std::strerror(error));
+            }
+            this->modules.push_back(Watched{ wd, slash == std::string::npos ? path : path.substr(slash + 1) });
+        }
+    }
+
+    ModuleWatcher::~ModuleWatcher() {
+        close(this->fd);
+    }
+
+    std::vector<std::size_t> ModuleWatcher::wait(std::chrono::milliseconds settle) {
+        std::vector<std::size_t> changed;
+        alignas(struct inotify_event) char buffer[4096];
+
+        while (true) {
+            // blocks until the first change, afterwards only as long as writes keep coming in
+            struct pollfd pfd = { this->fd, POLLIN, 0 };
+            int ready = poll(&pfd, 1, changed.empty() ? -1 : static_cast<int>(settle.count()));
+            if (ready < 0 && errno == EINTR) {
+                continue;
+            }
+            if (ready <= 0) {
+                return changed;
+            }
+
+            ssize_t length = read(this->fd, buffer, sizeof(buffer));
+            if (length < 0) {
+                if (errno == EINTR || errno == EAGAIN) {
+                    continue;
+                }
+                throw std::runtime_error(std::string("Could not read inotify events: ") + std::strerror(errno));
+            }
+
+            for (char* pos = buffer; pos < buffer + length; ) {
+                const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(pos);
+                pos += sizeof(struct inotify_event) + event->len;
+                if (event->len == 0) {
+                    continue;
+                }
+                for (std::size_t i = 0; i < this->modules.size(); i++) {
+                    if (this->modules[i].wd == event->wd && this->modules[i].filename == event->name
+                        && std::find(changed.begin(), changed.end(), i) == changed.end()
+                    ) {
+                        changed.push_back(i);
+                    }
+                }
+            }
+        }
+    }
+
+}
@@ -0,0 +1,60 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace cxxspec {
+
+    /**
+     * Waits for spec modules to be rebuilt. Uses inotify on the directories containing the modules instead of
+     * the files themselves, as builds tend to replace files rather than writing them in place.
+     */
+    class ModuleWatcher {
+    public:
+        /**
+         * @throws std::runtime_error if a directory can't be watched
+         */
+        explicit ModuleWatcher(const std::vector<std::string>& paths);
+        ~ModuleWatcher();
+
+        ModuleWatcher(const ModuleWatcher&) = delete;
+        ModuleWatcher& operator=(const ModuleWatcher&) = delete;
+
+        /**
+         * Blocks until at least one module was written and no further writes followed for `settle`,
+         * so half-linked modules aren't picked up
+         *
+         * @return indices (into the paths given to the constructor) of all modules that were written
+         */
+        std::vector<std::size_t> wait(std::chrono::milliseconds settle = std::chrono::milliseconds(200));
+
+    private:
+        struct Watched {
+            int wd;
+            std::string filename;
+        };
+
+        int fd = -1;
+        std::vector<Watched> modules;
+    };
+
+}
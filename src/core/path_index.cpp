@@ -0,0 +1,59 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "./path_index.hpp"
+
+namespace cxxspec {
+
+    PathIndex::Node& PathIndex::node(const std::vector<std::string>& path, std::size_t length) {
+        Node* current = &this->_root;
+        for (std::size_t i = 0; i < length; i++) {
+            std::unique_ptr<Node>& next = current->children[path[i]];
+            if (!next) {
+                next.reset(new Node());
+            }
+            current = next.get();
+        }
+        return *current;
+    }
+
+    void PathIndex::insertSpec(const std::vector<std::string>& path) {
+        this->node(path, path.size()).whole = true;
+    }
+
+    void PathIndex::insertExample(const std::vector<std::string>& path) {
+        if (path.empty()) {
+            return;
+        }
+        this->node(path, path.size() - 1).examples.insert(path.back());
+    }
+
+    void PathIndex::insertPath(const std::vector<std::string>& path) {
+        this->insertSpec(path);
+        this->insertExample(path);
+    }
+
+    const PathIndex::Node* PathIndex::find(const std::vector<std::string>& path) const {
+        const Node* current = &this->_root;
+        for (std::size_t i = 0; i < path.size() && current != nullptr; i++) {
+            current = current->child(path[i]);
+        }
+        return current;
+    }
+
+}
\ No newline at end of file
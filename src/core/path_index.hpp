@@ -0,0 +1,88 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace cxxspec {
+
+    /**
+     * A trie of spec paths (the descriptions from the top-level spec downwards), used to select
+     * parts of the spec tree by hashed lookups instead of scanning every spec on every level.
+     */
+    class PathIndex {
+    public:
+        struct Node {
+            std::unordered_map<std::string, std::unique_ptr<Node>> children;
+            // names of the examples directly inside this spec that are selected
+            std::unordered_set<std::string> examples;
+            // the whole subtree is selected
+            bool whole = false;
+            // set by whoever consumes the index once the spec or example of this node was found
+            mutable bool found = false;
+
+            const Node* child(const std::string& desc) const {
+                auto it = this->children.find(desc);
+                return it == this->children.end() ? nullptr : it->second.get();
+            }
+
+            bool empty() const {
+                return !this->whole && this->children.empty() && this->examples.empty();
+            }
+        };
+
+        /**
+         * Selects the whole spec with the given path
+         */
+        void insertSpec(const std::vector<std::string>& path);
+
+        /**
+         * Selects a single example; the last element of the path is the name of the example
+         */
+        void insertExample(const std::vector<std::string>& path);
+
+        /**
+         * Selects the spec or the example with the given path, whichever exists
+         */
+        void insertPath(const std::vector<std::string>& path);
+
+        /**
+         * Node of the given path; nullptr if there is none
+         */
+        const Node* find(const std::vector<std::string>& path) const;
+
+        const Node& root() const {
+            return this->_root;
+        }
+
+        bool empty() const {
+            return this->_root.empty();
+        }
+
+    private:
+        Node& node(const std::vector<std::string>& path, std::size_t length);
+
+        Node _root;
+    };
+
+}
\ No newline at end of file
@@ -0,0 +1,153 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "./plan.hpp"
+#include "./watchdog.hpp"
+
+#include <algorithm>
+
+namespace cxxspec {
+
+    ExecutionPlan::ExecutionPlan(const std::vector<Spec*>& specs) {
+        int specLimit = specs.size() - 1;
+        for (int i = 0; i <= specLimit; i++) {
+            this->compile(*specs.at(i), -1, i < specLimit);
+        }
+    }
+
+    void ExecutionPlan::compile(Spec& spec, long parent, bool hasNext) {
+        spec.defineChilds();
+
+        std::size_t index = this->specs.size();
+        this->specs.push_back(SpecNode{ &spec, parent, 0 });
+        // only valid until the subspecs below add their nodes
+        SpecNode& node = this->specs.back();
+
+        this->events.push_back(Event{ EVENT_ENTER_SPEC, index, false });
+
+        // same order as Spec::run(): first all subspecs, then our own examples
+        std::vector<Spec*> subspecs = spec.selectedSubSpecs();
+        std::vector<Example*> examples = spec.selectedExamples();
+        node.work = subspecs.size() + examples.size();
+
+        int subspecLimit = subspecs.size() - 1;
+        for (int i = 0; i <= subspecLimit; i++) {
+            this->compile(*subspecs.at(i), index, i < subspecLimit || examples.size() > 0);
+        }
+
+        int exampleLimit = examples.size() - 1;
+        for (int i = 0; i <= exampleLimit; i++) {
+            this->events.push_back(Event{ EVENT_EXAMPLE, this->entries.size(), i < exampleLimit });
+            this->entries.push_back(Entry{ examples.at(i), index });
+        }
+
+        this->events.push_back(Event{ EVENT_LEAVE_SPEC, index, hasNext });
+    }
+
+    void ExecutionPlan::runExample(std::size_t index, Watchdog* watchdog) {
+        Entry& entry = this->entries.at(index);
+        entry.example->setResult(this->specs.at(entry.spec).spec->executeExample(*entry.example, watchdog));
+    }
+
+    void ExecutionPlan::estimate(const DurationHistory& history) {
+        std::vector<std::vector<std::string>> paths;
+        paths.reserve(this->entries.size());
+        for (Entry& entry : this->entries) {
+            paths.push_back(entry.example->path());
+        }
+
+        std::vector<ExampleDuration> expected = history.predict(paths);
+        for (std::size_t i = 0; i < this->entries.size(); i++) {
+            this->entries[i].expected = expected[i];
+        }
+        this->estimated = true;
+    }
+
+    std::vector<std::size_t> ExecutionPlan::order() const {
+        std::vector<std::size_t> list(this->entries.size());
+        for (std::size_t i = 0; i < list.size(); i++) {
+            list[i] = i;
+        }
+        if (this->estimated) {
+            // prioritized examples keep running first
+            std::stable_sort(list.begin(), list.end(), [this] (std::size_t a, std::size_t b) {
+                const Entry& x = this->entries[a];
+                const Entry& y = this->entries[b];
+                if (x.example->isPrioritized() != y.example->isPrioritized()) {
+                    return x.example->isPrioritized();
+                }
+                return x.expected > y.expected;
+            });
+        }
+        return list;
+    }
+
+    std::vector<std::size_t> ExecutionPlan::chain(std::size_t spec) const {
+        std::vector<std::size_t> list;
+        for (long i = spec; i >= 0; i = this->specs.at(i).parent) {
+            list.push_back(i);
+        }
+        std::reverse(list.begin(), list.end());
+        return list;
+    }
+
+    //--------------------------------------------------------------------------------
+
+    PlanReporter::PlanReporter(ExecutionPlan& plan, Formatter& formatter)
+        : plan(plan), formatter(formatter), done(plan.entries.size(), false)
+    {}
+
+    void PlanReporter::markDone(std::size_t entry) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->done[entry] = true;
+        }
+        this->cond.notify_one();
+    }
+
+    void PlanReporter::flush(bool wait) {
+        std::vector<ExecutionPlan::Event>& events = this->plan.events;
+        while (this->next < events.size()) {
+            ExecutionPlan::Event& event = events[this->next];
+            switch (event.type) {
+                case ExecutionPlan::EVENT_ENTER_SPEC:
+                    this->formatter.onEnterSpec(*this->plan.specs.at(event.index).spec);
+                    break;
+
+                case ExecutionPlan::EVENT_LEAVE_SPEC:
+                    this->formatter.onLeaveSpec(*this->plan.specs.at(event.index).spec, event.hasNext);
+                    break;
+
+                case ExecutionPlan::EVENT_EXAMPLE: {
+                    std::unique_lock<std::mutex> lock(this->mutex);
+                    if (!this->done[event.index]) {
+                        if (!wait) {
+                            return;
+                        }
+                        this->cond.wait(lock, [this, &event] { return this->done[event.index]; });
+                    }
+                    lock.unlock();
+                    this->plan.entries.at(event.index).example->report(this->formatter, event.hasNext);
+                    break;
+                }
+            }
+            this->next++;
+        }
+    }
+
+}
\ No newline at end of file
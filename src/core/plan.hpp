@@ -0,0 +1,139 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./core.hpp"
+#include "./formatter.hpp"
+#include "./history.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace cxxspec {
+
+    /**
+     * The selected part of a defined spec tree, flattened into a list of examples that can be
+     * executed in any order, plus the list of formatter events to replay their results in definition order.
+     */
+    class ExecutionPlan {
+    public:
+        struct SpecNode {
+            Spec* spec;
+            // index of the parent node; -1 for top-level specs
+            long parent;
+            // number of examples & subspecs directly inside this spec
+            std::size_t work;
+        };
+
+        struct Entry {
+            Example* example;
+            // index of the node owning the example
+            std::size_t spec;
+            // expected duration from the history; zero if the plan wasn't estimated
+            ExampleDuration expected = ExampleDuration::zero();
+        };
+
+        enum EventType {
+            EVENT_ENTER_SPEC,
+            EVENT_EXAMPLE,
+            EVENT_LEAVE_SPEC,
+        };
+
+        struct Event {
+            EventType type;
+            // index of the node for spec events, of the entry for example events
+            std::size_t index;
+            bool hasNext;
+        };
+
+        /**
+         * Compiles the selected examples of the given specs; defines the specs where needed
+         */
+        ExecutionPlan(const std::vector<Spec*>& specs);
+
+        /**
+         * Runs the example of the entry together with it's before_each, after_each & around_each hooks.
+         * `before_all` hooks of the surrounding specs must have been run already.
+         * With a watchdog, the example is failed once it exceeds it's timeout. A failing hook fails the example.
+         */
+        void runExample(std::size_t index, Watchdog* watchdog = nullptr);
+
+        /**
+         * Fills in the expected duration of every entry from a history of previous runs
+         */
+        void estimate(const DurationHistory& history);
+
+        bool isEstimated() const {
+            return this->estimated;
+        }
+
+        /**
+         * Indices of all entries in the order they should be started: longest expected first
+         * if the plan was estimated, definition order otherwise
+         */
+        std::vector<std::size_t> order() const;
+
+        /**
+         * Indices of all nodes from the top-level spec down to the given one
+         */
+        std::vector<std::size_t> chain(std::size_t spec) const;
+
+        // entries point to the hook chains of their specs (not of the nodes), so nodes may move
+        std::vector<SpecNode> specs;
+        std::vector<Entry> entries;
+        std::vector<Event> events;
+
+    private:
+        void compile(Spec& spec, long parent, bool hasNext);
+
+        bool estimated = false;
+    };
+
+    /**
+     * Replays the events of a plan to a formatter while it's examples are finishing in arbitrary order.
+     * Results are reported as soon as all examples defined before them are reported.
+     */
+    class PlanReporter {
+    public:
+        PlanReporter(ExecutionPlan& plan, Formatter& formatter);
+
+        /**
+         * Marks the result of an entry as available; can be called from any thread
+         */
+        void markDone(std::size_t entry);
+
+        /**
+         * Reports all events that are ready. Must always be called from the same thread.
+         *
+         * @param wait  block until every event has been reported
+         */
+        void flush(bool wait);
+
+    private:
+        ExecutionPlan& plan;
+        Formatter& formatter;
+        std::size_t next = 0;
+
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::vector<bool> done;
+    };
+
+}
\ No newline at end of file
@@ -0,0 +1,407 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "./process_pool.hpp"
+#include "./watchdog.hpp"
+
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace cxxspec {
+
+    // wire format of a result: header followed by `reasonLength` bytes of reason
+    struct ResultHeader {
+        std::uint32_t index;
+        std::uint8_t success;
+        std::int64_t nanoseconds;
+        std::uint32_t reasonLength;
+    };
+
+    static bool readFully(int fd, void* data, std::size_t size) {
+        char* buf = static_cast<char*>(data);
+        while (size > 0) {
+            ssize_t n = ::read(fd, buf, size);
+            if (n < 0 && errno == EINTR) { continue; }
+            if (n <= 0) { return false; }
+            buf += n; size -= n;
+        }
+        return true;
+    }
+
+    static bool writeFully(int fd, const void* data, std::size_t size) {
+        const char* buf = static_cast<const char*>(data);
+        while (size > 0) {
+            ssize_t n = ::write(fd, buf, size);
+            if (n < 0 && errno == EINTR) { continue; }
+            if (n <= 0) { return false; }
+            buf += n; size -= n;
+        }
+        return true;
+    }
+
+    static std::string signalName(int sig) {
+        switch (sig) {
+            case SIGSEGV: return "SIGSEGV";
+            case SIGABRT: return "SIGABRT";
+            case SIGBUS:  return "SIGBUS";
+            case SIGFPE:  return "SIGFPE";
+            case SIGILL:  return "SIGILL";
+            case SIGKILL: return "SIGKILL";
+            case SIGTERM: return "SIGTERM";
+            case SIGINT:  return "SIGINT";
+            case SIGPIPE: return "SIGPIPE";
+            case SIGTRAP: return "SIGTRAP";
+            case SIGSYS:  return "SIGSYS";
+            default:      return "signal " + std::to_string(sig);
+        }
+    }
+
+    //--------------------------------------------------------------------------------
+
+    ProcessPool::ProcessPool(ExecutionPlan& plan, unsigned workers, bool forkEach, FailureBudget* budget, ExampleDuration defaultTimeout)
+        : plan(plan), workers(workers > 0 ? workers : 1), forkEach(forkEach), budget(budget), defaultTimeout(defaultTimeout)
+    {}
+
+    ProcessPool::~ProcessPool() {
+        for (Worker& worker : this->workers) {
+            if (worker.commandFd >= 0) { ::close(worker.commandFd); }
+            if (worker.resultFd >= 0) { ::close(worker.resultFd); }
+            if (worker.pid > 0) { ::waitpid(worker.pid, nullptr, 0); }
+        }
+    }
+
+    void ProcessPool::spawn(Worker& worker) {
+        int commandPipe[2], resultPipe[2];
+        if (::pipe(commandPipe) != 0) {
+            throw std::runtime_error(std::string("Could not create pipe: ") + std::strerror(errno));
+        }
+        if (::pipe(resultPipe) != 0) {
+            ::close(commandPipe[0]); ::close(commandPipe[1]);
+            throw std::runtime_error(std::string("Could not create pipe: ") + std::strerror(errno));
+        }
+
+        // anything still buffered would otherwise be written twice
+        std::cout.flush();
+        std::cerr.flush();
+        std::fflush(nullptr);
+
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            throw std::runtime_error(std::string("Could not fork worker: ") + std::strerror(errno));
+        }
+        if (pid == 0) {
+            ::close(commandPipe[1]);
+            ::close(resultPipe[0]);
+            // the pipes of our siblings belong to the parent only
+            for (Worker& other : this->workers) {
+                if (other.commandFd >= 0) { ::close(other.commandFd); }
+                if (other.resultFd >= 0) { ::close(other.resultFd); }
+            }
+            // keep output written right before a crash
+            std::setvbuf(stdout, nullptr, _IOLBF, BUFSIZ);
+            this->workerMain(commandPipe[0], resultPipe[1]);
+        }
+
+        ::close(commandPipe[0]);
+        ::close(resultPipe[1]);
+        worker.pid = pid;
+        worker.commandFd = commandPipe[1];
+        worker.resultFd = resultPipe[0];
+        worker.current = -1;
+    }
+
+    void ProcessPool::workerMain(int commandFd, int resultFd) {
+        std::vector<std::size_t> entered;
+        std::uint32_t index;
+
+        while (readFully(commandFd, &index, sizeof(index))) {
+            Example& ex = *this->plan.entries.at(index).example;
+
+            // hook failures are reported the same way as by the scheduler of `--jobs`
+            ExampleResult result;
+            std::string failure;
+
+            // leave the specs we don't need anymore and enter the new ones
+            std::vector<std::size_t> chain = this->plan.chain(this->plan.entries.at(index).spec);
+            std::size_t common = 0;
+            while (common < entered.size() && common < chain.size() && entered[common] == chain[common]) {
+                common++;
+            }
+            while (entered.size() > common) {
+                this->leave(entered.back());
+                entered.pop_back();
+            }
+            while (entered.size() < chain.size()) {
+                std::size_t spec = chain[entered.size()];
+                try {
+                    this->plan.specs.at(spec).spec->enter();
+                }
+                catch (...) {
+                    failure = "before_all/around_all hook failed: " + util::describe_current_exception();
+                    break;
+                }
+                entered.push_back(spec);
+            }
+
+            if (!failure.empty()) {
+                result.reason = failure;
+            }
+            else {
+                this->plan.runExample(index);
+                result = ex.result();
+            }
+
+            ResultHeader header;
+            header.index = index;
+            header.success = result.success ? 1 : 0;
+            header.nanoseconds = result.timeTaken.count();
+            header.reasonLength = result.reason.size();
+            std::string message(reinterpret_cast<const char*>(&header), sizeof(header));
+            message += result.reason;
+            if (!writeFully(resultFd, message.data(), message.size()) || this->forkEach) {
+                break;
+            }
+        }
+
+        while (!entered.empty()) {
+            this->leave(entered.back());
+            entered.pop_back();
+        }
+
+        std::cout.flush();
+        std::cerr.flush();
+        std::fflush(nullptr);
+        // skip static destructors & atexit handlers; they belong to the parent
+        ::_exit(0);
+    }
+
+    void ProcessPool::leave(std::size_t spec) {
+        try {
+            this->plan.specs.at(spec).spec->leave();
+        }
+        catch (...) {
+            std::cerr << "cxxspec: after_all/around_all hook of '" << this->plan.specs.at(spec).spec->fulldesc() << "' failed: "
+                      << util::describe_current_exception() << "\n";
+        }
+    }
+
+    bool ProcessPool::dispatch(Worker& worker, std::size_t index) {
+        if (worker.pid < 0) {
+            this->spawn(worker);
+        }
+        std::uint32_t msg = index;
+        worker.current = index;
+        worker.started = Clock::now();
+        worker.timeout = this->plan.entries.at(index).example->timeout();
+        if (worker.timeout <= ExampleDuration::zero()) {
+            worker.timeout = this->defaultTimeout;
+        }
+        worker.timedOut = false;
+        return writeFully(worker.commandFd, &msg, sizeof(msg));
+    }
+
+    bool ProcessPool::receive(Worker& worker, PlanReporter& reporter) {
+        ResultHeader header;
+        if (!readFully(worker.resultFd, &header, sizeof(header))) {
+            return false;
+        }
+        std::string reason(header.reasonLength, '\0');
+        if (header.reasonLength > 0 && !readFully(worker.resultFd, &reason[0], reason.size())) {
+            return false;
+        }
+
+        ExampleResult result;
+        result.success = header.success != 0;
+        result.reason = reason;
+        result.timeTaken = ExampleDuration(header.nanoseconds);
+        this->plan.entries.at(header.index).example->setResult(result);
+        if (this->budget != nullptr) {
+            this->budget->account(result);
+        }
+        reporter.markDone(header.index);
+        worker.current = -1;
+        return true;
+    }
+
+    void ProcessPool::reap(Worker& worker, PlanReporter* reporter) {
+        if (worker.commandFd >= 0) { ::close(worker.commandFd); }
+        if (worker.resultFd >= 0) { ::close(worker.resultFd); }
+        worker.commandFd = worker.resultFd = -1;
+
+        int status = 0;
+        while (::waitpid(worker.pid, &status, 0) < 0 && errno == EINTR) {}
+        worker.pid = -1;
+
+        if (worker.current < 0) {
+            if (WIFSIGNALED(status)) {
+                std::cerr << "cxxspec: worker crashed outside of an example (" << signalName(WTERMSIG(status)) << ")\n";
+            }
+            return;
+        }
+
+        ExampleResult result;
+        result.success = false;
+        result.timeTaken = std::chrono::duration_cast<ExampleDuration>(Clock::now() - worker.started);
+        std::stringstream ss;
+        if (worker.timedOut) {
+            ss << timeoutReason(result.timeTaken);
+        }
+        else if (WIFSIGNALED(status)) {
+            int sig = WTERMSIG(status);
+            ss << "Crashed with " << signalName(sig) << " (" << strsignal(sig) << ")";
+        }
+        else {
+            ss << "Worker exited unexpectedly with status " << WEXITSTATUS(status);
+        }
+        result.reason = ss.str();
+        this->plan.entries.at(worker.current).example->setResult(result);
+        if (this->budget != nullptr) {
+            this->budget->account(result);
+        }
+        if (reporter != nullptr) {
+            reporter->markDone(worker.current);
+        }
+        worker.current = -1;
+    }
+
+    int ProcessPool::pollTimeout() const {
+        int timeout = -1;
+        Clock::time_point now = Clock::now();
+        for (const Worker& worker : this->workers) {
+            if (worker.current < 0 || worker.timeout <= ExampleDuration::zero()) {
+                continue;
+            }
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(worker.started + worker.timeout - now).count() + 1;
+            if (left < 0) {
+                left = 0;
+            }
+            if (timeout < 0 || left < timeout) {
+                timeout = left;
+            }
+        }
+        return timeout;
+    }
+
+    void ProcessPool::run(PlanReporter& reporter) {
+        // a worker dying while we write to it must not kill us
+        struct sigaction ignore, previous;
+        std::memset(&ignore, 0, sizeof(ignore));
+        ignore.sa_handler = SIG_IGN;
+        ::sigaction(SIGPIPE, &ignore, &previous);
+
+        // idle workers take the next entry, so starting with the longest ones is already LPT scheduling
+        std::vector<std::size_t> order = this->plan.order();
+        std::size_t next = 0;
+        std::size_t busy = 0;
+        std::vector<pollfd> fds;
+        std::vector<Worker*> polled;
+
+        while (next < this->plan.entries.size() || busy > 0) {
+            if (this->budget != nullptr && this->budget->exhausted()) {
+                // examples already running are allowed to finish
+                for (; next < this->plan.entries.size(); next++) {
+                    this->plan.entries.at(order[next]).example->setResult(this->budget->skippedResult());
+                    reporter.markDone(order[next]);
+                }
+            }
+
+            for (Worker& worker : this->workers) {
+                if (worker.current >= 0 || next >= this->plan.entries.size()) {
+                    continue;
+                }
+                if (this->dispatch(worker, order[next])) {
+                    next++;
+                    busy++;
+                }
+                else {
+                    // died while idle; the example is handed to its replacement
+                    worker.current = -1;
+                    this->reap(worker, nullptr);
+                }
+            }
+
+            fds.clear();
+            polled.clear();
+            for (Worker& worker : this->workers) {
+                if (worker.current >= 0) {
+                    fds.push_back(pollfd{ worker.resultFd, POLLIN, 0 });
+                    polled.push_back(&worker);
+                }
+            }
+            if (fds.empty()) {
+                continue;
+            }
+
+            if (::poll(fds.data(), fds.size(), this->pollTimeout()) < 0) {
+                if (errno == EINTR) { continue; }
+                throw std::runtime_error(std::string("poll() failed: ") + std::strerror(errno));
+            }
+
+            for (std::size_t i = 0; i < fds.size(); i++) {
+                if (fds[i].revents == 0) {
+                    continue;
+                }
+                Worker& worker = *polled[i];
+                busy--;
+                if (!this->receive(worker, reporter) || this->forkEach) {
+                    this->reap(worker, &reporter);
+                }
+            }
+
+            Clock::time_point now = Clock::now();
+            for (Worker& worker : this->workers) {
+                if (worker.current >= 0 && worker.timeout > ExampleDuration::zero() && now - worker.started >= worker.timeout) {
+                    // a hung example can't be interrupted, so the whole worker goes
+                    ::kill(worker.pid, SIGKILL);
+                    worker.timedOut = true;
+                    busy--;
+                    this->reap(worker, &reporter);
+                }
+            }
+
+            reporter.flush(false);
+        }
+
+        // closing the command pipes lets all workers run their after_all hooks and exit
+        for (Worker& worker : this->workers) {
+            if (worker.commandFd >= 0) {
+                ::close(worker.commandFd);
+                worker.commandFd = -1;
+            }
+        }
+        for (Worker& worker : this->workers) {
+            if (worker.pid > 0) {
+                this->reap(worker, &reporter);
+            }
+        }
+
+        ::sigaction(SIGPIPE, &previous, nullptr);
+        reporter.flush(true);
+    }
+
+}
\ No newline at end of file
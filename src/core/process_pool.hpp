@@ -0,0 +1,90 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./plan.hpp"
+
+#include <chrono>
+#include <vector>
+#include <sys/types.h>
+
+namespace cxxspec {
+
+    /**
+     * Runs examples in forked worker processes, so crashing examples (segfaults, `abort()`, ...)
+     * only take down their worker instead of the whole run. Crashed workers are replaced and the
+     * example they were running is failed with the signal that killed it.
+     *
+     * Workers are forked once and reused for many examples; each worker runs the `before_all` hooks of
+     * a spec when it first needs them and the `after_all` hooks when it moves on to another spec or exits.
+     * A worker whose example exceeds it's timeout is killed, so it doesn't run any of these.
+     */
+    class ProcessPool {
+    public:
+        /**
+         * @param plan      the examples to run; must outlive the pool
+         * @param workers   number of worker processes running concurrently
+         * @param forkEach  use a fresh process for every single example
+         * @param budget    once exhausted, no further examples are dispatched; the rest is skipped
+         * @param defaultTimeout  timeout for examples without one of their own; zero for no limit.
+         *                        Workers exceeding the timeout of their example are killed.
+         */
+        ProcessPool(ExecutionPlan& plan, unsigned workers, bool forkEach = false, FailureBudget* budget = nullptr,
+                    ExampleDuration defaultTimeout = ExampleDuration::zero());
+        ~ProcessPool();
+
+        ProcessPool(const ProcessPool&) = delete;
+        ProcessPool& operator=(const ProcessPool&) = delete;
+
+        /**
+         * Runs all examples; results are reported as they arrive
+         */
+        void run(PlanReporter& reporter);
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        struct Worker {
+            pid_t pid = -1;
+            int commandFd = -1;
+            int resultFd = -1;
+            long current = -1;
+            Clock::time_point started;
+            // timeout of the current example; zero if there is none
+            ExampleDuration timeout = ExampleDuration::zero();
+            bool timedOut = false;
+        };
+
+        void spawn(Worker& worker);
+        void workerMain(int commandFd, int resultFd);
+        // runs the after_all hooks of a spec inside of a worker; a failure is only written to stderr
+        void leave(std::size_t spec);
+        bool dispatch(Worker& worker, std::size_t index);
+        bool receive(Worker& worker, PlanReporter& reporter);
+        void reap(Worker& worker, PlanReporter* reporter);
+        int pollTimeout() const;
+
+        ExecutionPlan& plan;
+        std::vector<Worker> workers;
+        bool forkEach;
+        FailureBudget* budget;
+        ExampleDuration defaultTimeout;
+    };
+
+}
\ No newline at end of file
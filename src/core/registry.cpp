@@ -0,0 +1,50 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "./registry.hpp"
+
+#include <mutex>
+
+namespace cxxspec {
+
+    // both constant initialized, so modules can register before any dynamic initialization took place
+    static std::mutex sectionsMutex;
+    static SpecSection* sections = nullptr;
+
+    void registerSpecSection(SpecSection& section) {
+        std::lock_guard<std::mutex> lock(sectionsMutex);
+        section.next = sections;
+        sections = &section;
+    }
+
+    void unregisterSpecSection(const SpecSection* section) {
+        std::lock_guard<std::mutex> lock(sectionsMutex);
+        for (SpecSection** link = &sections; *link != nullptr; link = &(*link)->next) {
+            if (*link == section) {
+                *link = (*link)->next;
+                return;
+            }
+        }
+    }
+
+    SpecSection* registeredSpecSections() {
+        std::lock_guard<std::mutex> lock(sectionsMutex);
+        return sections;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace cxxspec {
+
+    /**
+     * Constant record of a top-level spec; `define` adds the spec to `all_specs`.
+     * With ELF binaries, `describe` places these records in the `cxxspec_specs` section instead of
+     * registering the spec at startup, so nothing is done for them before `main`.
+     */
+    struct SpecDescriptor {
+        const char* name;
+        void (*define)();
+    };
+
+    /**
+     * The `cxxspec_specs` section of one module (executable or shared library); linked into a list by
+     * `registerSpecSection`, which neither allocates nor depends on the order of static initialization.
+     * Unloading the module removes it from the list again.
+     */
+    struct SpecSection {
+        const SpecDescriptor* begin;
+        const SpecDescriptor* end;
+        SpecSection* next;
+    };
+
+    void registerSpecSection(SpecSection& section);
+
+    /**
+     * Removes a section from the list; the pointer is only compared, so it may refer to an already unloaded module
+     */
+    void unregisterSpecSection(const SpecSection* section);
+
+    /**
+     * Head of the list of all registered sections; sections of the same module may be registered more than once
+     */
+    SpecSection* registeredSpecSections();
+
+}
+
+#if defined(__ELF__)
+    #define CXXSPEC_SPEC_SECTIONS 1
+
+    // defined by the linker for every module containing the section; hidden, so each module sees it's own
+    extern "C" {
+        extern const cxxspec::SpecDescriptor __start_cxxspec_specs[] __attribute__((weak, visibility("hidden")));
+        extern const cxxspec::SpecDescriptor __stop_cxxspec_specs[] __attribute__((weak, visibility("hidden")));
+    }
+
+    namespace {
+        // one per translation unit instead of one per spec; constant initialized, so only linking it is left to do at startup
+        cxxspec::SpecSection __cxxspec_section = { __start_cxxspec_specs, __stop_cxxspec_specs, nullptr };
+
+        __attribute__((constructor))
+        void __cxxspec_registerSection() {
+            cxxspec::registerSpecSection(__cxxspec_section);
+        }
+
+        __attribute__((destructor))
+        void __cxxspec_unregisterSection() {
+            cxxspec::unregisterSpecSection(&__cxxspec_section);
+        }
+    }
+#endif
\ No newline at end of file
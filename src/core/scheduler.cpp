@@ -0,0 +1,213 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "./scheduler.hpp"
+#include "./watchdog.hpp"
+
+#include <iostream>
+#include <thread>
+
+namespace cxxspec {
+
+    WorkStealingScheduler::WorkStealingScheduler(ExecutionPlan& plan, unsigned workers, FailureBudget* budget, ExampleDuration defaultTimeout)
+        : plan(plan), budget(budget), defaultTimeout(defaultTimeout), states(new SpecState[plan.specs.size()])
+    {
+        if (workers == 0) {
+            workers = 1;
+        }
+        for (unsigned i = 0; i < workers; i++) {
+            this->queues.emplace_back(new Queue());
+        }
+
+        for (std::size_t i = 0; i < plan.specs.size(); i++) {
+            this->states[i].pending.store(plan.specs[i].work);
+        }
+
+        std::size_t count = plan.entries.size();
+        if (plan.isEstimated()) {
+            // longest-processing-time-first: every worker gets about the same expected amount of work and
+            // starts with it's longest examples, so no long example is left for the end of the run
+            std::vector<ExampleDuration> expected;
+            expected.reserve(count);
+            for (const ExecutionPlan::Entry& entry : plan.entries) {
+                expected.push_back(entry.expected);
+            }
+            std::vector<unsigned> assignment = scheduleLongestFirst(expected, workers);
+            for (std::size_t entry : plan.order()) {
+                this->queues[assignment[entry]]->entries.push_back(entry);
+            }
+            return;
+        }
+
+        // contiguous slices keep the examples of a spec together on one worker as long as nobody steals them
+        for (unsigned i = 0; i < workers; i++) {
+            std::size_t begin = count * i / workers;
+            std::size_t end = count * (i + 1) / workers;
+            for (std::size_t entry = begin; entry < end; entry++) {
+                this->queues[i]->entries.push_back(entry);
+            }
+        }
+    }
+
+    void WorkStealingScheduler::run(PlanReporter& reporter) {
+        // specs without anything inside would never be finished by a worker
+        for (std::size_t i = 0; i < this->plan.specs.size(); i++) {
+            if (this->plan.specs[i].work == 0) {
+                this->enter(i);
+                this->finish(i);
+            }
+        }
+
+        std::vector<std::thread> threads;
+        for (unsigned i = 0; i < this->queues.size(); i++) {
+            threads.emplace_back([this, i, &reporter] { this->work(i, reporter); });
+        }
+
+        reporter.flush(true);
+
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    void WorkStealingScheduler::work(unsigned self, PlanReporter& reporter) {
+        Watchdog watchdog(this->defaultTimeout);
+        std::size_t index;
+        while (this->next(self, index)) {
+            ExecutionPlan::Entry& entry = this->plan.entries[index];
+
+            if (this->budget != nullptr && this->budget->exhausted()) {
+                entry.example->setResult(this->budget->skippedResult());
+                reporter.markDone(index);
+                this->finish(entry.spec);
+                continue;
+            }
+
+            const std::string& failure = this->enter(entry.spec);
+            if (!failure.empty()) {
+                ExampleResult result;
+                result.reason = failure;
+                entry.example->setResult(result);
+            }
+            else {
+                this->plan.runExample(index, &watchdog);
+            }
+
+            if (this->budget != nullptr) {
+                this->budget->account(entry.example->result());
+            }
+            reporter.markDone(index);
+            this->finish(entry.spec);
+        }
+    }
+
+    bool WorkStealingScheduler::next(unsigned self, std::size_t& entry) {
+        Queue& own = *this->queues[self];
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(own.mutex);
+                if (!own.entries.empty()) {
+                    entry = own.entries.front();
+                    own.entries.pop_front();
+                    return true;
+                }
+            }
+            // no new work ever appears, so once nothing can be stolen we are done
+            if (!this->steal(self)) {
+                return false;
+            }
+        }
+    }
+
+    bool WorkStealingScheduler::steal(unsigned self) {
+        std::deque<std::size_t> loot;
+        for (std::size_t i = 1; i < this->queues.size() && loot.empty(); i++) {
+            Queue& victim = *this->queues[(self + i) % this->queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+
+            // take the back half; the victim keeps working on the entries it is closest to
+            std::size_t amount = (victim.entries.size() + 1) / 2;
+            loot.insert(loot.end(), victim.entries.end() - amount, victim.entries.end());
+            victim.entries.erase(victim.entries.end() - amount, victim.entries.end());
+        }
+        if (loot.empty()) {
+            return false;
+        }
+
+        Queue& own = *this->queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        own.entries.insert(own.entries.end(), loot.begin(), loot.end());
+        return true;
+    }
+
+    const std::string& WorkStealingScheduler::enter(std::size_t spec) {
+        SpecState& state = this->states[spec];
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (state.entered) {
+            return state.failure;
+        }
+
+        long parent = this->plan.specs[spec].parent;
+        if (parent >= 0) {
+            // parents are entered before their childs; locks are always taken from child to parent, so this can't deadlock
+            const std::string& parentFailure = this->enter(parent);
+            if (!parentFailure.empty()) {
+                state.failure = parentFailure;
+            }
+        }
+        if (state.failure.empty()) {
+            try {
+                this->plan.specs[spec].spec->enter();
+            }
+            catch (...) {
+                state.failure = "before_all/around_all hook failed: " + util::describe_current_exception();
+            }
+        }
+        state.entered = true;
+        return state.failure;
+    }
+
+    void WorkStealingScheduler::finish(std::size_t spec) {
+        SpecState& state = this->states[spec];
+        std::size_t work = this->plan.specs[spec].work;
+        if (work > 0 && --state.pending > 0) {
+            return;
+        }
+
+        bool entered;
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            entered = state.entered;
+        }
+        if (entered && state.failure.empty()) {
+            try {
+                this->plan.specs[spec].spec->leave();
+            }
+            catch (...) {
+                std::cerr << "cxxspec: after_all/around_all hook of '" << this->plan.specs[spec].spec->fulldesc() << "' failed: "
+                          << util::describe_current_exception() << "\n";
+            }
+        }
+
+        long parent = this->plan.specs[spec].parent;
+        if (parent >= 0) {
+            this->finish(parent);
+        }
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./plan.hpp"
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace cxxspec {
+
+    /**
+     * Executes a plan on a set of worker threads. Every worker owns a deque of entries it works through
+     * in definition order; once it runs dry it steals half of the remaining entries of another worker.
+     *
+     * `before_all` hooks of a spec run on the worker that first needs them, `after_all` hooks on the worker
+     * that finishes the last example or subspec of the spec, so their order relative to the examples is
+     * the same as in a serial run. Specs that were never entered (because all their examples were skipped)
+     * don't run their `after_all` hooks either.
+     */
+    class WorkStealingScheduler {
+    public:
+        /**
+         * @param budget          once exhausted, workers skip all entries they haven't started yet
+         * @param defaultTimeout  timeout for examples without one of their own; zero for no limit
+         */
+        WorkStealingScheduler(ExecutionPlan& plan, unsigned workers, FailureBudget* budget = nullptr, ExampleDuration defaultTimeout = ExampleDuration::zero());
+
+        /**
+         * Runs the whole plan; the calling thread reports the results while the workers are busy
+         */
+        void run(PlanReporter& reporter);
+
+    private:
+        struct Queue {
+            std::mutex mutex;
+            std::deque<std::size_t> entries;
+        };
+
+        struct SpecState {
+            std::mutex mutex;
+            bool entered = false;
+            // set when a before_all (or around_all) hook failed; all examples of the spec fail with it
+            std::string failure;
+            std::atomic<std::size_t> pending;
+        };
+
+        void work(unsigned self, PlanReporter& reporter);
+        bool next(unsigned self, std::size_t& entry);
+        bool steal(unsigned self);
+
+        const std::string& enter(std::size_t spec);
+        void finish(std::size_t spec);
+
+        ExecutionPlan& plan;
+        FailureBudget* budget;
+        ExampleDuration defaultTimeout;
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::unique_ptr<SpecState[]> states;
+    };
+
+}
\ No newline at end of file
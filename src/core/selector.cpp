@@ -0,0 +1,354 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "./selector.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace cxxspec {
+
+    std::vector<std::string> splitPath(const std::string& path) {
+        std::vector<std::string> parts;
+        std::size_t start = 0;
+        while (true) {
+            std::size_t pos = path.find('/', start);
+            parts.push_back(path.substr(start, pos == std::string::npos ? std::string::npos : pos - start));
+            if (pos == std::string::npos) {
+                return parts;
+            }
+            start = pos + 1;
+        }
+    }
+
+    static bool isGlob(const std::string& pattern) {
+        return pattern.find_first_of("*?[\\") != std::string::npos;
+    }
+
+    static bool isRegex(const std::string& pattern) {
+        return pattern.size() >= 2 && pattern.front() == '/' && pattern.back() == '/';
+    }
+
+    // matches a character class starting after the '['; `pos` is moved behind the closing ']'
+    static bool matchClass(const std::string& glob, std::size_t& pos, char c) {
+        bool negate = pos < glob.size() && (glob[pos] == '!' || glob[pos] == '^');
+        if (negate) {
+            pos++;
+        }
+        bool match = false;
+        bool first = true;
+        while (pos < glob.size() && (first || glob[pos] != ']')) {
+            first = false;
+            char low = glob[pos++];
+            char high = low;
+            if (pos + 1 < glob.size() && glob[pos] == '-' && glob[pos + 1] != ']') {
+                high = glob[pos + 1];
+                pos += 2;
+            }
+            if (low <= c && c <= high) {
+                match = true;
+            }
+        }
+        pos++; // the ']'
+        return match != negate;
+    }
+
+    // glob match of a single description; `*` backtracks to the last star only, which is enough without '/'
+    static bool globMatch(const std::string& glob, const std::string& str) {
+        std::size_t g = 0, s = 0;
+        std::size_t starG = std::string::npos, starS = 0;
+        while (s < str.size()) {
+            if (g < glob.size() && glob[g] == '*') {
+                starG = g++;
+                starS = s;
+                continue;
+            }
+            if (g < glob.size()) {
+                std::size_t next = g;
+                bool match = false;
+                if (glob[g] == '?') {
+                    match = true;
+                    next = g + 1;
+                }
+                else if (glob[g] == '[' && glob.find(']', g + 2) != std::string::npos) {
+                    next = g + 1;
+                    match = matchClass(glob, next, str[s]);
+                }
+                else if (glob[g] == '\\' && g + 1 < glob.size()) {
+                    match = glob[g + 1] == str[s];
+                    next = g + 2;
+                }
+                else {
+                    match = glob[g] == str[s];
+                    next = g + 1;
+                }
+                if (match) {
+                    g = next;
+                    s++;
+                    continue;
+                }
+            }
+            if (starG == std::string::npos) {
+                return false;
+            }
+            g = starG + 1;
+            s = ++starS;
+        }
+        while (g < glob.size() && glob[g] == '*') {
+            g++;
+        }
+        return g == glob.size();
+    }
+
+    Selector::Pattern Selector::compile(const std::string& pattern) {
+        Pattern compiled;
+        compiled.source = pattern;
+        if (isRegex(pattern)) {
+            compiled.isRegex = true;
+            try {
+                compiled.regex = std::regex(pattern.substr(1, pattern.size() - 2));
+            }
+            catch (const std::regex_error& e) {
+                throw std::runtime_error("Invalid regex '" + pattern + "': " + e.what());
+            }
+        }
+        else {
+            compiled.segments = splitPath(pattern);
+        }
+        return compiled;
+    }
+
+    void Selector::include(const std::string& pattern) {
+        if (!isRegex(pattern)) {
+            // also looked up literally, as descriptions may contain characters that are special in globs
+            this->literals.insertPath(splitPath(pattern));
+            if (!isGlob(pattern)) {
+                Pattern literal;
+                literal.source = pattern;
+                this->includes.push_back(literal);
+                return;
+            }
+        }
+        this->includes.push_back(compile(pattern));
+    }
+
+    void Selector::exclude(const std::string& pattern) {
+        this->excludes.push_back(compile(pattern));
+    }
+
+    Selector::States Selector::closure(const Pattern& pattern, States states) {
+        for (std::size_t i = 0; i < states.size(); i++) {
+            std::size_t state = states[i];
+            if (state < pattern.segments.size() && pattern.segments[state] == "**"
+                && std::find(states.begin(), states.end(), state + 1) == states.end()
+            ) {
+                states.push_back(state + 1);
+            }
+        }
+        return states;
+    }
+
+    Selector::States Selector::advance(const Pattern& pattern, const States& states, const std::string& desc) {
+        States next;
+        for (std::size_t state : states) {
+            if (state >= pattern.segments.size()) {
+                continue;
+            }
+            std::size_t target = state;
+            if (pattern.segments[state] != "**") {
+                if (!globMatch(pattern.segments[state], desc)) {
+                    continue;
+                }
+                target = state + 1;
+            }
+            if (std::find(next.begin(), next.end(), target) == next.end()) {
+                next.push_back(target);
+            }
+        }
+        return closure(pattern, next);
+    }
+
+    static bool isFullMatch(const std::vector<std::string>& segments, const std::vector<std::size_t>& states) {
+        return std::find(states.begin(), states.end(), segments.size()) != states.end();
+    }
+
+    std::size_t Selector::apply(std::vector<Spec>& specs) {
+        Cursor root;
+        root.node = &this->literals.root();
+        root.whole = this->includes.empty();
+        for (Pattern& pattern : this->includes) {
+            root.includes.push_back(closure(pattern, States{ 0 }));
+        }
+        for (Pattern& pattern : this->excludes) {
+            root.excludes.push_back(closure(pattern, States{ 0 }));
+        }
+
+        std::size_t count = 0;
+        for (Spec& spec : specs) {
+            count += this->select(spec, root);
+        }
+
+        for (Pattern& pattern : this->includes) {
+            const PathIndex::Node* literal = pattern.isRegex ? nullptr : this->literals.find(splitPath(pattern.source));
+            if (!pattern.matched && (literal == nullptr || !literal->found)) {
+                throw std::runtime_error("Could not find spec '" + pattern.source + "'");
+            }
+        }
+        return count;
+    }
+
+    bool Selector::mayInclude(const std::string& desc) const {
+        for (const Pattern& pattern : this->excludes) {
+            if (pattern.isRegex ? std::regex_search(desc, pattern.regex)
+                                : isFullMatch(pattern.segments, advance(pattern, closure(pattern, States{ 0 }), desc))
+            ) {
+                return false;
+            }
+        }
+
+        if (this->includes.empty() || this->literals.root().child(desc) != nullptr) {
+            return true;
+        }
+        for (const Pattern& pattern : this->includes) {
+            if (pattern.isRegex || (!pattern.segments.empty() && !advance(pattern, closure(pattern, States{ 0 }), desc).empty())) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::size_t Selector::select(Spec& spec, const Cursor& parent) {
+        Cursor cursor;
+        cursor.path = parent.path.empty() ? spec.desc() : parent.path + "/" + spec.desc();
+
+        for (std::size_t i = 0; i < this->excludes.size(); i++) {
+            Pattern& pattern = this->excludes[i];
+            bool excluded;
+            if (pattern.isRegex) {
+                excluded = std::regex_search(cursor.path, pattern.regex);
+                cursor.excludes.push_back(States());
+            }
+            else {
+                cursor.excludes.push_back(advance(pattern, parent.excludes[i], spec.desc()));
+                excluded = isFullMatch(pattern.segments, cursor.excludes.back());
+            }
+            if (excluded) {
+                spec.deselect();
+                return 0;
+            }
+        }
+
+        cursor.whole = parent.whole;
+        cursor.node = parent.node != nullptr ? parent.node->child(spec.desc()) : nullptr;
+        if (cursor.node != nullptr && cursor.node->whole) {
+            cursor.node->found = true;
+            cursor.whole = true;
+        }
+
+        bool reachable = cursor.whole || cursor.node != nullptr;
+        for (std::size_t i = 0; i < this->includes.size(); i++) {
+            Pattern& pattern = this->includes[i];
+            if (pattern.isRegex) {
+                reachable = true;
+                if (!cursor.whole && std::regex_search(cursor.path, pattern.regex)) {
+                    pattern.matched = true;
+                    cursor.whole = true;
+                }
+                cursor.includes.push_back(States());
+                continue;
+            }
+            cursor.includes.push_back(pattern.segments.empty() ? States() : advance(pattern, parent.includes[i], spec.desc()));
+            if (isFullMatch(pattern.segments, cursor.includes.back()) && !pattern.segments.empty()) {
+                pattern.matched = true;
+                cursor.whole = true;
+            }
+            if (!cursor.includes.back().empty()) {
+                reachable = true;
+            }
+        }
+
+        if (!reachable) {
+            // nothing inside can be included anymore, so there's no need to define it
+            spec.deselect();
+            return 0;
+        }
+        if (spec.filtered && spec.selectedCount == 0) {
+            return 0;
+        }
+        if (cursor.whole && this->excludes.empty()) {
+            return spec.selectExamples([] (const Example&) -> bool { return true; });
+        }
+
+        spec.defineChilds();
+
+        std::size_t count = 0;
+        for (Spec* sub : spec.subspecs) {
+            count += this->select(*sub, cursor);
+        }
+        for (Example* ex : spec.examples) {
+            if (ex->isSelected() && (!this->isIncluded(cursor, *ex) || this->isExcluded(cursor, *ex))) {
+                ex->setSelected(false);
+            }
+            if (ex->isSelected()) {
+                count++;
+            }
+        }
+
+        spec.filtered = true;
+        spec.selectedCount = count;
+        return count;
+    }
+
+    bool Selector::isIncluded(const Cursor& cursor, const Example& ex) {
+        bool included = cursor.whole;
+        if (cursor.node != nullptr && cursor.node->examples.count(ex.name()) > 0) {
+            cursor.node->child(ex.name())->found = true;
+            included = true;
+        }
+
+        std::string path = cursor.path + "/" + ex.name();
+        for (std::size_t i = 0; i < this->includes.size(); i++) {
+            Pattern& pattern = this->includes[i];
+            if (pattern.isRegex) {
+                if (std::regex_search(path, pattern.regex)) {
+                    pattern.matched = true;
+                    included = true;
+                }
+            }
+            else if (!cursor.includes[i].empty() && isFullMatch(pattern.segments, advance(pattern, cursor.includes[i], ex.name()))) {
+                pattern.matched = true;
+                included = true;
+            }
+        }
+        return included;
+    }
+
+    bool Selector::isExcluded(const Cursor& cursor, const Example& ex) {
+        std::string path = cursor.path + "/" + ex.name();
+        for (std::size_t i = 0; i < this->excludes.size(); i++) {
+            const Pattern& pattern = this->excludes[i];
+            if (pattern.isRegex ? std::regex_search(path, pattern.regex)
+                                : isFullMatch(pattern.segments, advance(pattern, cursor.excludes[i], ex.name()))
+            ) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./core.hpp"
+#include "./path_index.hpp"
+
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace cxxspec {
+
+    /**
+     * Selects parts of the spec tree by their paths: the descriptions of the specs from the top-level one downwards,
+     * followed by the name of the example, separated by '/' (i.e. `mytest/my_stdstr/should contain the letter 'w'`).
+     *
+     * Patterns are either
+     *  - globs: `*` and `?` match inside a single description, `[...]` matches a character class and a segment
+     *    of just `**` matches any number of descriptions. Plain paths are looked up in a `PathIndex`.
+     *  - regexes when enclosed in slashes (`/hel+o/`); they are searched for anywhere in the path.
+     *
+     * A pattern matching a spec includes or excludes the whole spec. Specs that can't be matched by any include
+     * pattern anymore, as well as excluded ones, are pruned without being defined. Regexes can match anything,
+     * so including by regex defines the whole tree.
+     */
+    class Selector {
+    public:
+        void include(const std::string& pattern);
+        void exclude(const std::string& pattern);
+
+        bool empty() const {
+            return this->includes.empty() && this->excludes.empty();
+        }
+
+        /**
+         * Narrows the selection of the given specs to the included and not excluded examples
+         *
+         * @throws std::runtime_error if an include pattern didn't match anything
+         * @return number of examples still selected
+         */
+        std::size_t apply(std::vector<Spec>& specs);
+
+        /**
+         * Whether anything in a top-level spec with the given description could be selected; used to skip
+         * loading spec modules before their specs are known
+         */
+        bool mayInclude(const std::string& desc) const;
+
+    private:
+        struct Pattern {
+            std::string source;
+            bool isRegex = false;
+            std::regex regex;
+            std::vector<std::string> segments;
+            bool matched = false;
+        };
+
+        // positions in the segments of a glob that are reachable with the path so far
+        typedef std::vector<std::size_t> States;
+
+        struct Cursor {
+            std::string path;
+            const PathIndex::Node* node;
+            bool whole;
+            std::vector<States> includes;
+            std::vector<States> excludes;
+        };
+
+        static Pattern compile(const std::string& pattern);
+        static States advance(const Pattern& pattern, const States& states, const std::string& desc);
+        static States closure(const Pattern& pattern, States states);
+
+        std::size_t select(Spec& spec, const Cursor& parent);
+        bool isIncluded(const Cursor& cursor, const Example& ex);
+        bool isExcluded(const Cursor& cursor, const Example& ex);
+
+        std::vector<Pattern> includes;
+        std::vector<Pattern> excludes;
+        PathIndex literals;
+    };
+
+    /**
+     * Splits a path at '/'
+     */
+    std::vector<std::string> splitPath(const std::string& path);
+
+}
\ No newline at end of file
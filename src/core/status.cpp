@@ -0,0 +1,123 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "./status.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+namespace cxxspec {
+
+    // descriptions may contain anything, so tabs, newlines & backslashes are escaped
+    static std::string escapeField(const std::string& str) {
+        std::string buf;
+        buf.reserve(str.size());
+        for (char c : str) {
+            switch (c) {
+                case '\\': buf.append("\\\\"); break;
+                case '\t': buf.append("\\t"); break;
+                case '\n': buf.append("\\n"); break;
+                case '\r': buf.append("\\r"); break;
+                default: buf.push_back(c); break;
+            }
+        }
+        return buf;
+    }
+
+    static std::vector<std::string> splitLine(const std::string& line) {
+        std::vector<std::string> fields(1);
+        for (std::size_t i = 0; i < line.size(); i++) {
+            char c = line[i];
+            if (c == '\t') {
+                fields.emplace_back();
+            }
+            else if (c == '\\' && i + 1 < line.size()) {
+                char next = line[++i];
+                fields.back().push_back(next == 't' ? '\t' : next == 'n' ? '\n' : next == 'r' ? '\r' : next);
+            }
+            else {
+                fields.back().push_back(c);
+            }
+        }
+        return fields;
+    }
+
+    void StatusStore::load(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) {
+            return;
+        }
+
+        std::string line;
+        std::size_t lineNumber = 0;
+        while (std::getline(file, line)) {
+            lineNumber++;
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+
+            std::vector<std::string> fields = splitLine(line);
+            if (fields.size() < 3 || (fields[0] != "passed" && fields[0] != "failed")) {
+                throw std::runtime_error("Malformed example status in " + path + ":" + std::to_string(lineNumber));
+            }
+            bool failed = fields[0] == "failed";
+            fields.erase(fields.begin());
+            this->statuses[fields] = failed;
+        }
+    }
+
+    void StatusStore::save(const std::string& path) const {
+        std::string tmp = path + ".tmp";
+        {
+            std::ofstream file(tmp, std::ios::trunc);
+            file << "# cxxspec example status; <status> <spec>... <example>, separated by tabs\n";
+            for (auto& entry : this->statuses) {
+                file << (entry.second ? "failed" : "passed");
+                for (const std::string& field : entry.first) {
+                    file << '\t' << escapeField(field);
+                }
+                file << '\n';
+            }
+            if (!file) {
+                throw std::runtime_error("Could not write example status: " + tmp);
+            }
+        }
+        if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+            throw std::runtime_error("Could not replace example status: " + path);
+        }
+    }
+
+    void StatusStore::record(const Example& example) {
+        if (example.result().skipped) {
+            return;
+        }
+        this->statuses[example.path()] = !example.result().success;
+    }
+
+    PathIndex StatusStore::failures() const {
+        PathIndex index;
+        for (auto& entry : this->statuses) {
+            if (entry.second) {
+                index.insertExample(entry.first);
+            }
+        }
+        return index;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./core.hpp"
+#include "./path_index.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace cxxspec {
+
+    /**
+     * Pass/fail status of every example from previous runs, keyed by the path of the example.
+     *
+     * The file is plain text with one example per line: the status (`passed` or `failed`) followed by the
+     * descriptions of the specs and the name of the example, all separated by tabs.
+     * Examples not run in the current run keep their previous status.
+     */
+    class StatusStore {
+    public:
+        /**
+         * Loads the statuses from a file; a missing file is treated as an empty store
+         *
+         * @throws std::runtime_error if the file contains a malformed line
+         */
+        void load(const std::string& path);
+
+        /**
+         * Writes all statuses to a file; the file is replaced atomically
+         */
+        void save(const std::string& path) const;
+
+        /**
+         * Records the result of an example that was executed
+         */
+        void record(const Example& example);
+
+        /**
+         * Index of all examples that failed the last time they ran
+         */
+        PathIndex failures() const;
+
+    private:
+        // path of the example => failed
+        std::map<std::vector<std::string>, bool> statuses;
+    };
+
+}
\ No newline at end of file
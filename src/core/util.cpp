@@ -25,6 +25,18 @@
     #warning "Platform not fully supported; missing symbol demangling support!"
 #endif
 
+#include <cstdio>
+#include <thread>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#if defined(__linux__)
+    #include <sched.h>
+#endif
+
 namespace cxxspec {
     namespace util {
 
@@ -48,5 +60,150 @@ namespace cxxspec {
             }
         #endif
 
+        std::string describe_current_exception() {
+            try {
+                throw;
+            }
+            catch (const std::exception& e) {
+                return "(" + current_exception_typename() + ") => " + e.what();
+            }
+            catch (...) {
+                return "(" + current_exception_typename() + ")";
+            }
+        }
+
+    
+        #if defined(__linux__)
+            /**
+             * Reads the cgroup path of the current process for the given controller (empty for cgroup v2)
+             */
+            static bool cgroup_path(const std::string& controller, std::string& path) {
+                std::ifstream file("/proc/self/cgroup");
+                std::string line;
+                while (std::getline(file, line)) {
+                    // format is "<id>:<controllers>:<path>"
+                    std::size_t first = line.find(':');
+                    std::size_t second = line.find(':', first + 1);
+                    if (first == std::string::npos || second == std::string::npos) {
+                        continue;
+                    }
+                    std::string controllers = line.substr(first + 1, second - first - 1);
+                    bool found = controller.empty() ? controllers.empty() : false;
+                    std::size_t off = 0;
+                    while (!found && off <= controllers.size()) {
+                        std::size_t end = controllers.find(',', off);
+                        if (end == std::string::npos) { end = controllers.size(); }
+                        found = controllers.compare(off, end - off, controller) == 0;
+                        off = end + 1;
+                    }
+                    if (found) {
+                        path = line.substr(second + 1);
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            /**
+             * Returns the cpu limit imposed by the cgroup quota, or 0 if there is none
+             */
+            static unsigned cgroup_cpu_limit() {
+                long long quota = -1, period = 0;
+                std::string path;
+
+                // cgroup v2: "<quota|max> <period>" in cpu.max; containers usually see their own cgroup as root
+                std::vector<std::string> candidates;
+                if (cgroup_path("", path) && path != "/") {
+                    candidates.push_back("/sys/fs/cgroup" + path + "/cpu.max");
+                }
+                candidates.push_back("/sys/fs/cgroup/cpu.max");
+                for (const std::string& candidate : candidates) {
+                    std::ifstream file(candidate);
+                    std::string max;
+                    if (file >> max >> period) {
+                        quota = (max == "max") ? -1 : std::stoll(max);
+                        break;
+                    }
+                }
+
+                // cgroup v1: cpu.cfs_quota_us is -1 when unlimited
+                if (period <= 0) {
+                    std::vector<std::string> bases;
+                    if (cgroup_path("cpu", path) && path != "/") {
+                        bases.push_back("/sys/fs/cgroup/cpu" + path);
+                        bases.push_back("/sys/fs/cgroup/cpu,cpuacct" + path);
+                    }
+                    bases.push_back("/sys/fs/cgroup/cpu");
+                    bases.push_back("/sys/fs/cgroup/cpu,cpuacct");
+                    for (const std::string& base : bases) {
+                        std::ifstream quota_file(base + "/cpu.cfs_quota_us");
+                        std::ifstream period_file(base + "/cpu.cfs_period_us");
+                        if ((quota_file >> quota) && (period_file >> period)) {
+                            break;
+                        }
+                        quota = -1; period = 0;
+                    }
+                }
+
+                if (quota <= 0 || period <= 0) {
+                    return 0;
+                }
+                // a quota of 1.5 cpus still allows two threads to make progress
+                return static_cast<unsigned>((quota + period - 1) / period);
+            }
+        #endif
+
+        unsigned available_cpus() {
+            unsigned count = std::thread::hardware_concurrency();
+
+            #if defined(__linux__)
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+                    count = static_cast<unsigned>(CPU_COUNT(&set));
+                }
+
+                unsigned limit = cgroup_cpu_limit();
+                if (limit > 0 && (count == 0 || limit < count)) {
+                    count = limit;
+                }
+            #endif
+
+            return count > 0 ? count : 1;
+        }
+
+        const std::string& intern(const std::string& str) {
+            // never destroyed, so interned strings stay valid during static destruction as well
+            static std::unordered_set<std::string>* pool = new std::unordered_set<std::string>();
+            static std::mutex mutex;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            return *pool->insert(str).first;
+        }
+
+        void write_json_string(std::ostream& stream, const std::string& str) {
+            stream << '"';
+            for (char c : str) {
+                switch (c) {
+                    case '"': stream << "\\\""; break;
+                    case '\\': stream << "\\\\"; break;
+                    case '\n': stream << "\\n"; break;
+                    case '\r': stream << "\\r"; break;
+                    case '\t': stream << "\\t"; break;
+                    default:
+                        if (static_cast<unsigned char>(c) < 0x20) {
+                            char buf[8];
+                            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                            stream << buf;
+                        }
+                        else {
+                            stream << c;
+                        }
+                        break;
+                }
+            }
+            stream << '"';
+        }
+
     }
 }
\ No newline at end of file
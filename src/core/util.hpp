@@ -19,6 +19,7 @@
 #pragma once
 
 #include <string>
+#include <cstdint>
 #include <ostream>
 #include <functional>
 #include <type_traits>
@@ -29,6 +30,42 @@ namespace cxxspec {
         std::string demangle(const char* mangledName);
         std::string current_exception_typename();
 
+        /**
+         * Describes the exception currently being handled as "(<type>) => <what>"; only callable inside of a catch block
+         */
+        std::string describe_current_exception();
+
+        /**
+         * Returns the number of cpus this process is allowed to use.
+         * Honors the cpu affinity mask as well as cgroup (v1 & v2) cpu quotas on linux,
+         * so it's suited for sizing worker pools inside containers.
+         */
+        unsigned available_cpus();
+
+        /**
+         * 64bit FNV-1a hash; unlike std::hash it's stable across platforms, builds and runs
+         */
+        inline std::uint64_t stable_hash(const std::string& str) {
+            std::uint64_t hash = 0xcbf29ce484222325ULL;
+            for (unsigned char c : str) {
+                hash ^= c;
+                hash *= 0x100000001b3ULL;
+            }
+            return hash;
+        }
+
+        /**
+         * Canonical copy of the string: equal strings share a single copy, which lives until the program ends.
+         * The pool is never shrunk, so only intern strings that repeat, i.e. the segments of names, not full names.
+         * Safe to call from multiple threads.
+         */
+        const std::string& intern(const std::string& str);
+
+        /**
+         * Writes the string as a quoted json string, escaping quotes, backslashes & control characters
+         */
+        void write_json_string(std::ostream& stream, const std::string& str);
+
         template<typename T>
         const T& unmove(T&& param) { return param; }
 
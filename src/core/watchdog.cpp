@@ -0,0 +1,120 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "./watchdog.hpp"
+
+#include <iomanip>
+#include <sstream>
+
+namespace cxxspec {
+
+    std::string timeoutReason(ExampleDuration elapsed) {
+        std::stringstream ss;
+        ss << "Timed out after " << std::fixed << std::setprecision(3)
+           << std::chrono::duration_cast<std::chrono::duration<double>>(elapsed).count() << "s";
+        return ss.str();
+    }
+
+    Watchdog::Watchdog(ExampleDuration defaultTimeout)
+        : defaultTimeout(defaultTimeout)
+    {}
+
+    Watchdog::~Watchdog() {
+        if (this->executor) {
+            {
+                std::lock_guard<std::mutex> lock(this->executor->mutex);
+                this->executor->stop = true;
+            }
+            this->executor->cond.notify_all();
+            this->thread.join();
+        }
+    }
+
+    ExampleDuration Watchdog::timeoutOf(const Example& example) const {
+        ExampleDuration timeout = example.timeout();
+        return timeout > ExampleDuration::zero() ? timeout : this->defaultTimeout;
+    }
+
+    void Watchdog::executorMain(std::shared_ptr<Executor> executor) {
+        std::unique_lock<std::mutex> lock(executor->mutex);
+        while (true) {
+            executor->cond.wait(lock, [&executor] { return executor->task || executor->stop; });
+            if (!executor->task) {
+                return;
+            }
+
+            std::function<ExampleResult()> task = std::move(executor->task);
+            executor->task = nullptr;
+            lock.unlock();
+            ExampleResult result;
+            std::exception_ptr error;
+            try {
+                result = task();
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+            lock.lock();
+
+            executor->result = result;
+            executor->error = error;
+            executor->done = true;
+            executor->cond.notify_all();
+        }
+    }
+
+    ExampleResult Watchdog::execute(Example& example, const std::function<ExampleResult()>& task) {
+        ExampleDuration timeout = this->timeoutOf(example);
+        if (timeout <= ExampleDuration::zero()) {
+            return task();
+        }
+
+        if (!this->executor) {
+            this->executor = std::make_shared<Executor>();
+            this->thread = std::thread(&Watchdog::executorMain, this->executor);
+        }
+
+        std::shared_ptr<Executor> executor = this->executor;
+        std::unique_lock<std::mutex> lock(executor->mutex);
+        executor->task = task;
+        executor->done = false;
+        executor->cond.notify_all();
+
+        auto start = std::chrono::steady_clock::now();
+        if (executor->cond.wait_for(lock, timeout, [&executor] { return executor->done; })) {
+            if (executor->error) {
+                std::rethrow_exception(executor->error);
+            }
+            return executor->result;
+        }
+
+        // the thread stops after the example returns (if it ever does)
+        executor->stop = true;
+        lock.unlock();
+        this->thread.detach();
+        this->executor.reset();
+
+        example.abandon();
+
+        ExampleResult result;
+        result.timeTaken = std::chrono::duration_cast<ExampleDuration>(std::chrono::steady_clock::now() - start);
+        result.reason = timeoutReason(result.timeTaken) + " (left running, without cleanups)";
+        return result;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "./core.hpp"
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace cxxspec {
+
+    /**
+     * Enforces example timeouts inside of the current process. Examples with a timeout are run (together with their
+     * hooks) on a separate executor thread while the calling thread watches the clock; when an example takes too long
+     * it's failed and the executor is abandoned (a thread can't be killed safely), so the next example gets a fresh one.
+     * The abandoned example keeps running alongside everything run after it.
+     *
+     * Every thread running examples needs its own watchdog.
+     */
+    class Watchdog {
+    public:
+        /**
+         * @param defaultTimeout  timeout for examples that have none set via the DSL; zero for no limit
+         */
+        Watchdog(ExampleDuration defaultTimeout = ExampleDuration::zero());
+        ~Watchdog();
+
+        Watchdog(const Watchdog&) = delete;
+        Watchdog& operator=(const Watchdog&) = delete;
+
+        /**
+         * Runs the task (the example and its hooks) and returns its outcome, or a failure once the example exceeds
+         * its timeout; the example is abandoned then. Rethrows whatever the task threw.
+         */
+        ExampleResult execute(Example& example, const std::function<ExampleResult()>& task);
+
+        /**
+         * Timeout that applies to the given example; zero if there is no limit
+         */
+        ExampleDuration timeoutOf(const Example& example) const;
+
+    private:
+        // shared with the executor thread, so an abandoned thread can finish without us
+        struct Executor {
+            std::mutex mutex;
+            std::condition_variable cond;
+            std::function<ExampleResult()> task;
+            bool done = false;
+            bool stop = false;
+            ExampleResult result;
+            std::exception_ptr error;
+        };
+
+        static void executorMain(std::shared_ptr<Executor> executor);
+
+        ExampleDuration defaultTimeout;
+        std::shared_ptr<Executor> executor;
+        std::thread thread;
+    };
+
+    /**
+     * Failure reason for an example that was stopped after the given time
+     */
+    std::string timeoutReason(ExampleDuration elapsed);
+
+}
\ No newline at end of file
@@ -20,11 +20,24 @@
 #include "./formatters/cli_formatter.hpp"
 #include "./formatters/json_formatter.hpp"
 #include "./formatters/junit_formatter.hpp"
-
+#include "./core/plan.hpp"
+#include "./core/scheduler.hpp"
+#include "./core/process_pool.hpp"
+#include "./core/history.hpp"
+#include "./core/status.hpp"
+#include "./core/watchdog.hpp"
+#include "./core/selector.hpp"
+#include "./core/module.hpp"
+#include "./core/module_watcher.hpp"
+
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <string>
 #include <fstream>
+#include <cstdio>
+#include <memory>
+#include <unordered_set>
 
 namespace cxxspec {
 
@@ -37,77 +50,381 @@ namespace cxxspec {
 
     std::vector<Spec> all_specs = std::vector<Spec>();
 
-    void runAllSpecs(Formatter& formatter, bool onlyMarked) {
-        formatter.onBeginTesting();
+    #if defined(CXXSPEC_SPEC_SECTIONS)
+        // every translation unit registers the section of it's module, but each one may only be defined once
+        static std::unordered_set<const SpecDescriptor*> loadedSections;
+    #endif
+
+    void loadSpecs() {
+        #if defined(CXXSPEC_SPEC_SECTIONS)
+            std::vector<const SpecSection*> pending;
+            std::size_t count = 0;
+            for (const SpecSection* section = registeredSpecSections(); section != nullptr; section = section->next) {
+                if (section->begin != section->end && loadedSections.insert(section->begin).second) {
+                    pending.push_back(section);
+                    count += section->end - section->begin;
+                }
+            }
+
+            // the list starts with the module registered last
+            std::reverse(pending.begin(), pending.end());
+            all_specs.reserve(all_specs.size() + count);
+            for (const SpecSection* section : pending) {
+                for (const SpecDescriptor* descriptor = section->begin; descriptor != section->end; descriptor++) {
+                    descriptor->define();
+                }
+            }
+        #endif
+    }
+
+    /**
+     * Decides by the names of their top-level specs which spec modules may contain selected specs
+     */
+    class ModuleFilter {
+    public:
+        ModuleFilter(const RunOptions& options, const StatusStore& statuses) : rerun(options.rerun) {
+            for (const std::string& pattern : options.include) {
+                this->selector.include(pattern);
+            }
+            for (const std::string& pattern : options.exclude) {
+                this->selector.exclude(pattern);
+            }
+            if (this->rerun == RERUN_ONLY_FAILURES) {
+                this->failures = statuses.failures();
+            }
+        }
 
+        /**
+         * @param[out] names  names of the top-level specs of the module; empty if they are unknown
+         */
+        bool isNeeded(const std::string& path, std::vector<std::string>& names) const {
+            if (!readModuleSpecNames(path, names)) {
+                return true;
+            }
+            for (const std::string& name : names) {
+                if (this->selector.mayInclude(name) && (this->rerun != RERUN_ONLY_FAILURES || this->failures.root().child(name) != nullptr)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        Selector selector;
+        RerunMode rerun;
+        PathIndex failures;
+    };
+
+    /**
+     * Loads the spec modules of the options that may contain selected specs
+     */
+    static void loadModules(const RunOptions& options, const StatusStore& statuses) {
+        if (options.modules.empty()) {
+            return;
+        }
+
+        ModuleFilter filter(options, statuses);
+        for (const std::string& path : options.modules) {
+            std::vector<std::string> names;
+            if (filter.isNeeded(path, names)) {
+                loadModule(path);
+            }
+        }
+    }
+
+    /**
+     * Narrows the selection of all_specs according to the options and returns the top-level specs that are left
+     */
+    static std::vector<Spec*> selectSpecs(bool onlyMarked, const RunOptions& options, const StatusStore& statuses, const DurationHistory& history) {
         if (onlyMarked) {
-            all_specs.erase(
-                std::remove_if(all_specs.begin(), all_specs.end(), [] (Spec& spec) -> bool {
-                    return !spec.isMarked() && !spec.hasMarkedSubSpecs();
-                }),
-                all_specs.end()
-            );
+            for (Spec& spec : all_specs) {
+                spec.selectMarked();
+            }
+        }
+
+        if (!options.include.empty() || !options.exclude.empty()) {
+            Selector selector;
+            for (const std::string& pattern : options.include) {
+                selector.include(pattern);
+            }
+            for (const std::string& pattern : options.exclude) {
+                selector.exclude(pattern);
+            }
+            selector.apply(all_specs);
+        }
+
+        if (options.rerun != RERUN_ALL) {
+            // looked up through an index, so specs without failures are never defined
+            PathIndex failures = statuses.failures();
+            for (Spec& spec : all_specs) {
+                const PathIndex::Node* node = failures.root().child(spec.desc());
+                if (options.rerun == RERUN_ONLY_FAILURES) {
+                    if (node != nullptr) {
+                        spec.selectIndexed(*node);
+                    }
+                    else {
+                        spec.deselect();
+                    }
+                }
+                else if (node != nullptr) {
+                    spec.prioritize(*node);
+                }
+            }
+        }
+
+        if (options.shardCount > 1) {
+            // the examples need to be defined to know their names, but specs that end up
+            // without an example in our shard are skipped, hooks included
+            unsigned shardIndex = options.shardIndex, shardCount = options.shardCount;
+            Spec::ExampleFilter inShard = [shardIndex, shardCount] (const Example& ex) -> bool {
+                return util::stable_hash(ex.fullname()) % shardCount == shardIndex;
+            };
+
+            if (!options.shardBalanceDigest.empty()) {
+                // balance by expected duration; every shard computes the same assignment only if they all
+                // see the same specs and the same history, otherwise examples would be run twice or not at all
+                std::string digest = history.digest();
+                if (digest != options.shardBalanceDigest) {
+                    throw std::runtime_error(
+                        "Can't balance shards: the history has the digest " + digest + " instead of " + options.shardBalanceDigest
+                        + "; every shard must be given the same history"
+                    );
+                }
+
+                std::vector<Example*> selected;
+                for (Spec& spec : all_specs) {
+                    spec.selectExamples([&selected] (const Example& ex) -> bool {
+                        selected.push_back(const_cast<Example*>(&ex));
+                        return true;
+                    });
+                }
+                std::vector<std::vector<std::string>> paths;
+                paths.reserve(selected.size());
+                for (Example* ex : selected) {
+                    paths.push_back(ex->path());
+                }
+                std::vector<unsigned> assignment = scheduleLongestFirst(history.predict(paths), shardCount);
+
+                std::unordered_set<const Example*> ours;
+                for (std::size_t i = 0; i < selected.size(); i++) {
+                    if (assignment[i] == shardIndex) {
+                        ours.insert(selected[i]);
+                    }
+                }
+                inShard = [ours] (const Example& ex) -> bool {
+                    return ours.count(&ex) > 0;
+                };
+            }
+
+            for (Spec& spec : all_specs) {
+                spec.selectExamples(inShard);
+            }
+        }
+
+        // specs are not removed from all_specs, as moving them would invalidate the parent pointers of their childs
+        std::vector<Spec*> specs;
+        for (Spec& spec : all_specs) {
+            if (spec.isSelected()) {
+                specs.push_back(&spec);
+            }
         }
+        std::stable_partition(specs.begin(), specs.end(), [] (const Spec* spec) { return spec->isPrioritized(); });
+        return specs;
+    }
+
+    /**
+     * Runs the given top-level specs and records the results in the status file & history of the options
+     */
+    static void runSelectedSpecs(Formatter& formatter, const std::vector<Spec*>& specs, const RunOptions& options, StatusStore& statuses, DurationHistory& history) {
+        FailureBudget budget(options.maxFailures);
+
+        formatter.onBeginTesting();
+
+        if (options.isolation == ISOLATION_NONE && options.jobs <= 1) {
+            Watchdog watchdog(options.defaultTimeout);
+            int specLimit = specs.size() - 1;
+            for (int i = 0; i <= specLimit; i++) {
+                specs.at(i)->run(formatter, i < specLimit, &budget, &watchdog);
+            }
+        }
+        else {
+            ExecutionPlan plan(specs);
+            PlanReporter reporter(plan, formatter);
+
+            if (!history.empty()) {
+                plan.estimate(history);
+            }
 
-        int specLimit = all_specs.size() - 1;
-        for (int i = 0; i <= specLimit; i++) {
-            Spec& spec = all_specs.at(i);
-            if (!onlyMarked) {
-                spec.run(formatter, i < specLimit);
+            if (options.isolation != ISOLATION_NONE) {
+                ProcessPool(plan, options.jobs, options.isolation == ISOLATION_FORK_EACH, &budget, options.defaultTimeout).run(reporter);
             }
             else {
-                spec.runMarkedOnly(formatter, i < specLimit);
+                WorkStealingScheduler(plan, options.jobs, &budget, options.defaultTimeout).run(reporter);
             }
         }
 
         formatter.onEndTesting();
+
+        if (options.fixtureStats) {
+            printFixtureStats(std::cerr);
+        }
+
+        // all examples that were selected to run
+        std::vector<Example*> selected;
+        if (!options.historyFile.empty() || !options.statusFile.empty()) {
+            for (Spec* spec : specs) {
+                spec->selectExamples([&selected] (const Example& ex) -> bool {
+                    selected.push_back(const_cast<Example*>(&ex));
+                    return true;
+                });
+            }
+        }
+        if (!options.historyFile.empty()) {
+            // examples that weren't selected are dropped from the history
+            for (Example* ex : selected) {
+                if (!ex->result().skipped) {
+                    history.record(ex->path(), ex->result().timeTaken);
+                }
+                else {
+                    history.keep(ex->path());
+                }
+            }
+            history.save(options.historyFile);
+        }
+        if (!options.statusFile.empty()) {
+            for (Example* ex : selected) {
+                statuses.record(*ex);
+            }
+            statuses.save(options.statusFile);
+        }
     }
 
-    void runSpecs(int argc, char** argv) {
-        if (argc <= 0) {
-            CliFormatter formatter(std::cout, false);
-            runAllSpecs(formatter);
-            return;
+    void runAllSpecs(Formatter& formatter, bool onlyMarked, const RunOptions& options) {
+        StatusStore statuses;
+        if (!options.statusFile.empty()) {
+            statuses.load(options.statusFile);
         }
 
-        std::vector<std::string> args;
-        for (int i = 0; i < argc; i++) {
-            args.push_back(std::string(argv[i]));
+        loadModules(options, statuses);
+        loadSpecs();
+
+        DurationHistory history;
+        if (!options.historyFile.empty()) {
+            history.load(options.historyFile);
         }
 
-        runSpecs(args);
+        runSelectedSpecs(formatter, selectSpecs(onlyMarked, options, statuses, history), options, statuses, history);
     }
 
-    bool markSpec(Formatter& formatter, std::string specpath, std::vector<Spec>& list, std::size_t off = 0UL) {
-
-        std::size_t pos = specpath.find_first_of('/', off);
-        std::string name = specpath.substr(off, pos);
+    void listAllSpecs(std::ostream& stream, ListFormat format, bool onlyMarked, const RunOptions& options) {
+        StatusStore statuses;
+        if (!options.statusFile.empty()) {
+            statuses.load(options.statusFile);
+        }
 
-        auto iter = std::find_if(list.begin(), list.end(), [&name] (Spec& spec) -> bool {
-            return spec.desc().compare(name) == 0;
-        });
+        loadModules(options, statuses);
+        loadSpecs();
 
-        if (iter == list.end()) {
-            throw std::runtime_error("Could not find spec '" + specpath + "'");
+        DurationHistory history;
+        if (!options.historyFile.empty()) {
+            history.load(options.historyFile);
         }
 
-        if (pos != std::string::npos) {
-            // define all subspecs so we can search them!
-            (*iter).defineChilds();
+        listSpecs(stream, selectSpecs(onlyMarked, options, statuses, history), format);
+    }
+
+    void watchSpecs(const FormatterFactory& makeFormatter, const RunOptions& options) {
+        #if !defined(CXXSPEC_SPEC_SECTIONS)
+            throw std::runtime_error("Watching spec modules is only supported for ELF binaries");
+        #else
+            if (options.modules.empty()) {
+                throw std::runtime_error("Watching needs at least one spec module");
+            }
+
+            ModuleWatcher watcher(options.modules);
+            std::vector<std::unique_ptr<ReloadableModule>> modules;
+            std::vector<std::size_t> changed;
+            for (const std::string& path : options.modules) {
+                changed.push_back(modules.size());
+                modules.emplace_back(new ReloadableModule(path));
+            }
+
+            bool first = true;
+            while (true) {
+                try {
+                    StatusStore statuses;
+                    if (!options.statusFile.empty()) {
+                        statuses.load(options.statusFile);
+                    }
+
+                    DurationHistory history;
+                    if (!options.historyFile.empty()) {
+                        history.load(options.historyFile);
+                    }
+
+                    // all_specs can't drop single specs, so the specs of all modules are defined anew; only the
+                    // changed modules are reloaded, the others keep their state (and their fixture pools)
+                    all_specs.clear();
+                    loadedSections.clear();
+
+                    ModuleFilter filter(options, statuses);
+                    std::unordered_set<std::string> rerun;
+                    bool rerunAll = first;
+                    for (std::size_t index : changed) {
+                        ReloadableModule& module = *modules[index];
+                        std::vector<std::string> names;
+                        if (!filter.isNeeded(module.path(), names)) {
+                            module.unload();
+                            continue;
+                        }
+                        try {
+                            module.reload();
+                        }
+                        catch (const std::runtime_error& e) {
+                            std::cerr << e.what() << std::endl;
+                            continue;
+                        }
+                        rerun.insert(names.begin(), names.end());
+                        rerunAll = rerunAll || names.empty();
+                    }
+
+                    loadSpecs();
+
+                    std::vector<Spec*> specs = selectSpecs(false, options, statuses, history);
+                    if (!rerunAll) {
+                        specs.erase(std::remove_if(specs.begin(), specs.end(), [&rerun] (const Spec* spec) {
+                            return rerun.count(spec->desc()) == 0;
+                        }), specs.end());
+                    }
 
-            std::vector<Spec>& sublist = (*iter).getSubSpecs();
-            if (markSpec(formatter, specpath, sublist, pos + 1)) {
-                (*iter).markAsHasMarkedSubSpecs();
+                    if (first || !specs.empty()) {
+                        std::unique_ptr<Formatter> formatter = makeFormatter();
+                        runSelectedSpecs(*formatter, specs, options, statuses, history);
+                    }
+                }
+                catch (const std::runtime_error& e) {
+                    std::cerr << e.what() << std::endl;
+                }
+
+                first = false;
+                changed = watcher.wait();
             }
+        #endif
+    }
+
+    void runSpecs(int argc, char** argv) {
+        if (argc <= 0) {
+            CliFormatter formatter(std::cout, false);
+            runAllSpecs(formatter);
+            return;
         }
-        else {
-            (*iter).mark();
-            return true;
-            // if ((*iter).getRuns() <= 0) {
-            //     (*iter).run(formatter);
-            // }
+
+        std::vector<std::string> args;
+        for (int i = 0; i < argc; i++) {
+            args.push_back(std::string(argv[i]));
         }
-        return false;
+
+        runSpecs(args);
     }
 
     enum FormatterType {
@@ -116,6 +433,7 @@ namespace cxxspec {
 
     void runSpecs(std::vector<std::string>& arguments) {
         #define CONSUME_ARG \
+            if (i + 1 >= arguments.size()) { throw std::runtime_error("Missing value for option: " + arg); } \
             i++; arg = arguments[i];
 
         std::string output_file = "-";
@@ -123,11 +441,14 @@ namespace cxxspec {
         bool force_colors = false;
         bool pretty_print = true;
         bool display_time = false;
+        RunOptions options;
+        bool list_only = false;
+        bool watch = false;
+        bool history_digest = false;
 
-        std::vector<std::string> to_run;
         try {
 
-            for (int i = 0; i < arguments.size(); i++) {
+            for (std::size_t i = 0; i < arguments.size(); i++) {
                 std::string arg = arguments[i];
 
                 if (arg[0] == '-') {
@@ -160,6 +481,8 @@ namespace cxxspec {
                     }
                     else if (arg == "-h" || arg == "--help") {
                         puts("Usage: specs [<options>] <specs to run>");
+                        puts("Specs to run are paths like 'spec/context/example'; they may contain globs (*, ?, [...], **)");
+                        puts("or be a regex enclosed in slashes (/regex/).");
                         puts("Available options:");
                         puts("  -h, --help          Displays this help");
                         puts("  -f <output>         Writes output to the specified file instead of the standard output.");
@@ -169,6 +492,37 @@ namespace cxxspec {
                         puts("  -c, --compact       Disables pretty printing of output for some formats.");
                         puts("                      Supported by: json");
                         puts("  -t, --time          Displays time taken when using the cli format");
+                        puts("  -e, --example <pattern>");
+                        puts("                      Runs the specs & examples matching <pattern>; same as passing it as spec to run");
+                        puts("  --exclude <pattern> Doesn't run the specs & examples matching <pattern>");
+                        puts("  --list              Lists the paths of the selected specs & examples (and the sourcefile of each");
+                        puts("                      example) instead of running them; as json with --format json");
+                        puts("  --jobs <n|auto>     Runs examples on <n> worker threads; 'auto' uses all cpus available");
+                        puts("                      to the process (honors affinity & cgroup cpu quotas)");
+                        puts("  --shard <i>/<n>     Only runs the i-th (starting at 1) of n disjoint parts of all examples");
+                        puts("  --isolate           Runs examples in reused worker processes (as many as --jobs), so that");
+                        puts("                      crashing examples are reported as failures");
+                        puts("  --isolate-each      Like --isolate, but forks a fresh process for every example");
+                        puts("  --fail-fast         Stops after the first failed example; the remaining ones are reported as skipped");
+                        puts("  --max-failures <n>  Stops after <n> failed examples");
+                        puts("  --status-file <file>");
+                        puts("                      Remembers whether each example passed or failed in <file>");
+                        puts("  --only-failures     Only runs examples that failed in their last run (needs --status-file)");
+                        puts("  --failures-first    Runs examples that failed in their last run before all others (needs --status-file)");
+                        puts("  --next-failure      Equivalent to --only-failures --fail-fast");
+                        puts("  --timeout <secs>    Fails examples that take longer than <secs> (fractions allowed), unless they");
+                        puts("                      set their own timeout");
+                        puts("  --history <file>    Reads durations of previous runs from <file> to start long examples first;");
+                        puts("                      writes the new durations back");
+                        puts("  --history-digest    Prints the digest of the --history file instead of running anything");
+                        puts("  --balance-shards <digest>");
+                        puts("                      Balances --shard by the durations of the --history file instead of by hash;");
+                        puts("                      fails unless it's digest is <digest>, so all shards use the same history");
+                        puts("  --fixture-stats     Reports creations, reuses & wait time of all fixture pools to stderr");
+                        puts("  --module <file>     Loads the specs of the spec module (shared object) <file>; modules without");
+                        puts("                      any selected spec aren't loaded");
+                        puts("  --watch             Keeps running: whenever a spec module is rebuilt, it's reloaded and only");
+                        puts("                      it's examples are run again");
                         exit(1);
                     }
                     else if (arg == "-j" || arg == "--json") {
@@ -183,16 +537,158 @@ namespace cxxspec {
                         display_time = true;
                         continue;
                     }
+                    else if (arg == "--jobs") {
+                        CONSUME_ARG;
+
+                        if (arg == "auto") {
+                            options.jobs = util::available_cpus();
+                        }
+                        else {
+                            std::size_t end = 0;
+                            unsigned long jobs = 0;
+                            try { jobs = std::stoul(arg, &end); } catch (std::logic_error&) {}
+                            if (end != arg.size() || jobs == 0) {
+                                throw std::runtime_error("Invalid job count: " + arg);
+                            }
+                            options.jobs = jobs;
+                        }
+
+                        continue;
+                    }
+                    else if (arg == "--isolate") {
+                        options.isolation = ISOLATION_POOL;
+                        continue;
+                    }
+                    else if (arg == "--isolate-each") {
+                        options.isolation = ISOLATION_FORK_EACH;
+                        continue;
+                    }
+                    else if (arg == "-e" || arg == "--example") {
+                        CONSUME_ARG;
+                        options.include.push_back(arg);
+                        continue;
+                    }
+                    else if (arg == "--exclude") {
+                        CONSUME_ARG;
+                        options.exclude.push_back(arg);
+                        continue;
+                    }
+                    else if (arg == "--list") {
+                        list_only = true;
+                        continue;
+                    }
+                    else if (arg == "--fail-fast") {
+                        options.maxFailures = 1;
+                        continue;
+                    }
+                    else if (arg == "--max-failures") {
+                        CONSUME_ARG;
+
+                        std::size_t end = 0;
+                        unsigned long count = 0;
+                        try { count = std::stoul(arg, &end); } catch (std::logic_error&) {}
+                        if (end != arg.size() || count == 0) {
+                            throw std::runtime_error("Invalid failure count: " + arg);
+                        }
+                        options.maxFailures = count;
+
+                        continue;
+                    }
+                    else if (arg == "--status-file") {
+                        CONSUME_ARG;
+                        options.statusFile = arg;
+                        continue;
+                    }
+                    else if (arg == "--only-failures") {
+                        options.rerun = RERUN_ONLY_FAILURES;
+                        continue;
+                    }
+                    else if (arg == "--failures-first") {
+                        options.rerun = RERUN_FAILURES_FIRST;
+                        continue;
+                    }
+                    else if (arg == "--next-failure") {
+                        options.rerun = RERUN_ONLY_FAILURES;
+                        options.maxFailures = 1;
+                        continue;
+                    }
+                    else if (arg == "--watch") {
+                        watch = true;
+                        continue;
+                    }
+                    else if (arg == "--module") {
+                        CONSUME_ARG;
+                        options.modules.push_back(arg);
+                        continue;
+                    }
+                    else if (arg == "--fixture-stats") {
+                        options.fixtureStats = true;
+                        continue;
+                    }
+                    else if (arg == "--timeout") {
+                        CONSUME_ARG;
+
+                        std::size_t end = 0;
+                        double seconds = 0;
+                        try { seconds = std::stod(arg, &end); } catch (std::logic_error&) {}
+                        if (end != arg.size() || !(seconds > 0)) {
+                            throw std::runtime_error("Invalid timeout: " + arg);
+                        }
+                        options.defaultTimeout = std::chrono::duration_cast<ExampleDuration>(std::chrono::duration<double>(seconds));
+
+                        continue;
+                    }
+                    else if (arg == "--history") {
+                        CONSUME_ARG;
+                        options.historyFile = arg;
+                        continue;
+                    }
+                    else if (arg == "--history-digest") {
+                        history_digest = true;
+                        continue;
+                    }
+                    else if (arg == "--balance-shards") {
+                        CONSUME_ARG;
+                        options.shardBalanceDigest = arg;
+                        continue;
+                    }
+                    else if (arg == "--shard") {
+                        CONSUME_ARG;
+
+                        unsigned index = 0, count = 0;
+                        char rest = 0;
+                        if (std::sscanf(arg.c_str(), "%u/%u%c", &index, &count, &rest) != 2 || index < 1 || index > count) {
+                            throw std::runtime_error("Invalid shard (expected <index>/<count>, starting at 1): " + arg);
+                        }
+                        options.shardIndex = index - 1;
+                        options.shardCount = count;
+
+                        continue;
+                    }
                     else {
                         throw std::runtime_error("Unknown option: " + arg);
                     }
                 }
                 else {
                     // seems to be a spec-path
-                    to_run.push_back(arg);
+                    options.include.push_back(arg);
                 }
             }
 
+            if (options.rerun != RERUN_ALL && options.statusFile.empty()) {
+                throw std::runtime_error("--only-failures, --failures-first and --next-failure need a --status-file");
+            }
+            if ((history_digest || !options.shardBalanceDigest.empty()) && options.historyFile.empty()) {
+                throw std::runtime_error("--history-digest and --balance-shards need a --history");
+            }
+
+            if (history_digest) {
+                DurationHistory history;
+                history.load(options.historyFile);
+                std::cout << history.digest() << '\n';
+                std::exit(0);
+            }
+
         } catch (std::runtime_error e) {
             std::cout << e.what() << '\n';
             std::exit(1);
@@ -201,47 +697,47 @@ namespace cxxspec {
         bool is_outfile_cout = (output_file == "-");
         std::ostream* stream = is_outfile_cout ? (&std::cout) : new std::ofstream(output_file);
 
-        Formatter* formatter = nullptr;
-        switch (formatter_type) {
-            case FT_CLI:
-                formatter = new CliFormatter(*stream, display_time);
-                ((TextFormatter*)formatter)->force_colors = force_colors;
-                break;
+        auto createFormatter = [&] () -> Formatter* {
+            TextFormatter* formatter = nullptr;
+            switch (formatter_type) {
+                case FT_CLI:
+                    formatter = new CliFormatter(*stream, display_time);
+                    break;
 
-            case FT_JSON:
-                formatter = new JsonFormatter(*stream, pretty_print);
-                ((TextFormatter*)formatter)->force_colors = force_colors;
-                break;
+                case FT_JSON:
+                    formatter = new JsonFormatter(*stream, pretty_print);
+                    break;
 
-            case FT_JUNIT:
-                formatter = new JunitFormatter(*stream, pretty_print);
-                ((TextFormatter*)formatter)->force_colors = force_colors;
-                break;
-        }
+                case FT_JUNIT:
+                    formatter = new JunitFormatter(*stream, pretty_print);
+                    break;
+            }
+            formatter->force_colors = force_colors;
+            return formatter;
+        };
+        Formatter* formatter = createFormatter();
 
-        if (to_run.size() <= 0) {
-            runAllSpecs(*formatter);
-        }
-        else {
-            // try to find specs to run...
-            try {
-                std::sort(to_run.begin(), to_run.end());
-                int specPathLimit = to_run.size() - 1;
-                for (int i = 0; i <= specPathLimit; i++) {
-                    std::string& specpath = to_run.at(i);
-                    markSpec(*formatter, specpath, all_specs);
-                }
-                runAllSpecs(*formatter, true);
+        try {
+            if (list_only) {
+                listAllSpecs(*stream, formatter_type == FT_JSON ? LIST_JSON : LIST_TEXT, false, options);
+            }
+            else if (watch) {
+                // results have to show up as soon as a run is done, not once the buffer is full
+                *stream << std::unitbuf;
+                watchSpecs([&createFormatter] () { return std::unique_ptr<Formatter>(createFormatter()); }, options);
             }
-            catch (std::runtime_error e) {
-                std::cout << e.what() << '\n';
-                stream->flush();
-                if (!is_outfile_cout)
-                    delete stream;
-                delete formatter;
-                std::exit(1);
+            else {
+                runAllSpecs(*formatter, false, options);
             }
         }
+        catch (std::runtime_error e) {
+            std::cout << e.what() << '\n';
+            stream->flush();
+            if (!is_outfile_cout)
+                delete stream;
+            delete formatter;
+            std::exit(1);
+        }
 
         stream->flush();
         if (!is_outfile_cout)
@@ -18,12 +18,19 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <vector>
 
 #include "./core/core.hpp"
 #include "./core/expect.hpp"
 #include "./core/formatter.hpp"
 #include "./core/exceptions.hpp"
+#include "./core/listing.hpp"
+#include "./core/async.hpp"
+#include "./core/let.hpp"
+#include "./core/fixture_pool.hpp"
+#include "./core/registry.hpp"
 
 namespace cxxspec {
 
@@ -42,9 +49,142 @@ namespace cxxspec {
      */
     const char* getVersion(int* major = nullptr, int* minor = nullptr, int* patch = nullptr);
 
+    /**
+     * All top-level specs; filled by `loadSpecs()`
+     */
     extern std::vector<Spec> all_specs;
 
-    void runAllSpecs(Formatter& formatter, bool onlyMarked = false);
+    /**
+     * Adds the specs of all modules loaded so far to `all_specs` (only ones that weren't added before);
+     * called by `runAllSpecs` & `listAllSpecs`
+     */
+    void loadSpecs();
+
+    enum IsolationMode {
+        // examples run inside the process calling runAllSpecs()
+        ISOLATION_NONE,
+        // examples run in a pool of forked worker processes that are reused
+        ISOLATION_POOL,
+        // every example runs in a freshly forked process
+        ISOLATION_FORK_EACH,
+    };
+
+    /**
+     * Options that control how specs are executed
+     */
+    enum RerunMode {
+        // runs all selected examples
+        RERUN_ALL,
+        // only runs the selected examples that failed in their last run
+        RERUN_ONLY_FAILURES,
+        // runs all selected examples, but the ones that failed in their last run first
+        RERUN_FAILURES_FIRST,
+    };
+
+    struct RunOptions {
+        /**
+         * Patterns of the specs & examples to run; all if empty. Patterns are paths of spec descriptions & example
+         * names separated by '/', optionally containing globs (`*`, `?`, `[...]`, `**`), or regexes enclosed in slashes.
+         */
+        std::vector<std::string> include;
+
+        /**
+         * Patterns of specs & examples not to run, even if they are included
+         */
+        std::vector<std::string> exclude;
+
+        /**
+         * Number of worker threads examples are executed on; with 1 everything runs on the calling thread.
+         * Formatter callbacks are always issued from the calling thread in definition order.
+         */
+        unsigned jobs = 1;
+
+        /**
+         * Only runs the examples of the shard `shardIndex` (zero-based) out of `shardCount`.
+         * Examples are assigned by a stable hash of their full name, so every process given the
+         * same count gets a disjoint part of the suite.
+         */
+        unsigned shardIndex = 0;
+        unsigned shardCount = 1;
+
+        /**
+         * Runs examples in separate processes, so a crashing example is reported as failure instead
+         * of taking down the whole run. `jobs` controls how many worker processes run concurrently.
+         */
+        IsolationMode isolation = ISOLATION_NONE;
+
+        /**
+         * File with the durations of previous runs; empty to disable. When it holds any durations, parallel runs
+         * start the longest examples first. The durations measured in this run are written back to it.
+         */
+        std::string historyFile;
+
+        /**
+         * Digest (`DurationHistory::digest()`) of the history all shards were given; empty to assign examples to
+         * shards by hash. If set, shards are balanced by expected time instead, which only partitions the examples
+         * if every shard uses the very same history, so the run fails if the history has a different digest.
+         */
+        std::string shardBalanceDigest;
+
+        /**
+         * Stops the run after this many failed examples; 0 for no limit. Examples that are already running
+         * are finished, all others are reported as skipped.
+         */
+        std::size_t maxFailures = 0;
+
+        /**
+         * File with the pass/fail status of every example; empty to disable. It's read before the run
+         * (for `rerun`) and updated with the results of all examples that were run.
+         */
+        std::string statusFile;
+
+        /**
+         * Which examples to run based on their status in `statusFile`
+         */
+        RerunMode rerun = RERUN_ALL;
+
+        /**
+         * Time an example may take unless it (or one of it's specs) sets it's own timeout via `set_timeout`;
+         * zero for no limit. Examples exceeding it are failed. In-process the example's thread is abandoned,
+         * with process isolation the worker running it is killed.
+         */
+        ExampleDuration defaultTimeout = ExampleDuration::zero();
+
+        /**
+         * Writes how often the instances of each fixture pool were created, reused & waited for to stderr after the run.
+         * With process isolation the pools live in the worker processes, so nothing is reported then.
+         */
+        bool fixtureStats = false;
+
+        /**
+         * Spec modules (shared objects containing specs) to load into the process before selecting specs;
+         * their specs are run together with all others. Modules none of whose specs can be selected by
+         * `include`, `exclude` or `rerun` aren't loaded at all.
+         */
+        std::vector<std::string> modules;
+    };
+
+    void runAllSpecs(Formatter& formatter, bool onlyMarked = false, const RunOptions& options = RunOptions());
+
+    /**
+     * Writes the paths of all specs & examples that `runAllSpecs` would run with the same options,
+     * without running any hooks or examples.
+     */
+    void listAllSpecs(std::ostream& stream, ListFormat format, bool onlyMarked = false, const RunOptions& options = RunOptions());
+
+    /**
+     * Creates the formatter for a single run of `watchSpecs`
+     */
+    typedef std::function<std::unique_ptr<Formatter>()> FormatterFactory;
+
+    /**
+     * Runs the specs of the spec modules in `options.modules`, then keeps watching the modules: whenever one is rebuilt,
+     * it's reloaded and only the examples it defines are run again, reported by a fresh formatter. The process and all
+     * unchanged modules stay loaded, so their global state and fixture pools stay warm. Never returns.
+     *
+     * @throws std::runtime_error if there are no modules or they can't be watched
+     */
+    void watchSpecs(const FormatterFactory& makeFormatter, const RunOptions& options);
 
     void runSpecs(std::vector<std::string>& arguments);
 
@@ -60,31 +200,61 @@ namespace cxxspec {
     // TODO: this only works on gcc; for alternatives see https://stackoverflow.com/questions/1113409/attribute-constructor-equivalent-in-vc
     #define cxxspec_autoload    __attribute__((constructor))
 
-    #define describe(name, block)       \
-        cxxspec_autoload                \
-        void __initSpec_##name () {     \
-            cxxspec::all_specs.push_back( cxxspec::Spec(#name, block) ); \
-        }
+    #if defined(CXXSPEC_SPEC_SECTIONS)
+        #define describe(name, block)       \
+            void __initSpec_##name () {     \
+                cxxspec::all_specs.push_back( cxxspec::Spec(#name, block) ); \
+            }                               \
+            __attribute__((used, section("cxxspec_specs"), aligned(sizeof(void*)))) \
+            static const cxxspec::SpecDescriptor __specDescriptor_##name = { #name, &__initSpec_##name }; \
+            __attribute__((used, section("cxxspec_names"))) \
+            static const char __specName_##name[] = #name;
+    #else
+        #define describe(name, block)       \
+            cxxspec_autoload                \
+            void __initSpec_##name () {     \
+                cxxspec::all_specs.push_back( cxxspec::Spec(#name, block) ); \
+            }
+    #endif
 
     #define explain     self._context
     #define context     self._context
 
     #define it(name, ...)  self._it(name, __FILE__, __VA_ARGS__)
 
+    #ifdef CXXSPEC_HAS_COROUTINES
+        #define it_async(name, ...)  cxxspec::_it_async(self, name, __FILE__, __VA_ARGS__)
+    #endif
+
+    #define set_timeout(duration)   self.setTimeout(duration);
+
+    #define aggregate_failures(...)             self.aggregate_failures([&] () { __VA_ARGS__ });
+    #define set_aggregate_failures(aggregate)   self.setAggregateFailures(aggregate);
+
+    // with `CXXSPEC_FAILURE_RECORDS` the example continues after a failed expectation; the ones after it aren't checked
     #define expect      self.expect
     #define cleanup     self.cleanup
 
     #define expect_throw(type, block)   self.expect_throw<type>(block);
     #define expect_no_throw             self.expect_no_throw
 
+    #define let(name, ...)          static auto name = cxxspec::makeLet(#name, [] (cxxspec::Example& self) { return __VA_ARGS__; });
+    #define let_eager(name, ...)    let(name, __VA_ARGS__) self._add_example_hook(cxxspec::Spec::HOOK_BEFORE, [] (cxxspec::Example& example) { name.get(example); });
+    #define subject(...)            let(subject, __VA_ARGS__)
+    #define val(name)               name.get(self)
+
     #define before_all(block)   self._add_spec_hook(cxxspec::Spec::HOOK_BEFORE, [] () { block });
     #define after_all(block)    self._add_spec_hook(cxxspec::Spec::HOOK_AFTER , [] () { block });
 
+    #define around_all(block)   self._add_around_all_hook([] (const cxxspec::Spec::Continuation& run) { block });
+    #define around_each(block)  self._add_around_each_hook([] (cxxspec::Example& example, const cxxspec::Spec::Continuation& run) { block });
+
     #define before_each(block)  self._add_example_hook(cxxspec::Spec::HOOK_BEFORE, [] (cxxspec::Example& example) { block });
     #define after_each(block)   self._add_example_hook(cxxspec::Spec::HOOK_AFTER , [] (cxxspec::Example& example) { block });
 
     #define $ [] (cxxspec::Spec& self) -> void
     #define _ [] (cxxspec::Example& self) -> void
+    #define _async [] (cxxspec::Example& self) -> cxxspec::Task
 
     #define CXXSPEC_MAIN    \
         int main(int argc, char** argv) { cxxspec::runSpecs(--argc, ++argv); return 0; }
@@ -92,4 +262,4 @@ namespace cxxspec {
     #define DEFINE_SPEC(name)       void __initSpec_##name();
     #define ALLOW_SPEC(name)        friend void ::__initSpec_##name();
 
-}
\ No newline at end of file
+}
\ No newline at end of file
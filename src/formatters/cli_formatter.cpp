@@ -38,6 +38,9 @@ namespace cxxspec {
         stream << "========================================\n";
     }
     void CliFormatter::onEndTesting() {
+        if (this->skipped > 0) {
+            stream << "Skipped " << this->skipped << " example" << (this->skipped == 1 ? "" : "s") << "\n";
+        }
         stream << "========================================\n";
         stream << "End testing "; put_time(); stream << "\n";
     }
@@ -88,7 +91,14 @@ namespace cxxspec {
             }
             stream << "\n";
             chi(1);
-                i(); stream << reason << "\n";
+                // every line of multi-line reasons (i.e. aggregated failures) is indented
+                std::size_t start = 0;
+                std::size_t end;
+                while ((end = reason.find('\n', start)) != std::string::npos) {
+                    i(); stream.write(reason.data() + start, end - start) << "\n";
+                    start = end + 1;
+                }
+                i(); stream.write(reason.data() + start, reason.size() - start) << "\n";
             chi(-1);
         }
         if (this->useColors())
@@ -98,5 +108,16 @@ namespace cxxspec {
         stream << std::defaultfloat;
     }
     void CliFormatter::onLeaveExample(Example& example, bool hasNextElement) {}
+    void CliFormatter::onExampleSkipped(Example& example, std::string reason) {
+        last_line_empty = false;
+        this->skipped++;
+
+        i();
+        if (this->useColors())
+            stream << "\e[33m";
+        stream << example.name() << " (skipped)\n";
+        if (this->useColors())
+            stream << "\e[0m";
+    }
 
 }
\ No newline at end of file
@@ -30,6 +30,7 @@ namespace cxxspec {
         void put_time();
         bool last_line_empty = false;
         bool display_time = false;
+        std::size_t skipped = 0;
 
     public:
         CliFormatter(std::ostream& stream, bool display_time) : TextFormatter(stream), display_time(display_time) {}
@@ -43,6 +44,7 @@ namespace cxxspec {
         void onEnterExample(Example& example);
         void onExampleResult(Example& example, bool result, std::string reason, ExampleDuration timeTaken);
         void onLeaveExample(Example& example, bool hasNextElement);
+        void onExampleSkipped(Example& example, std::string reason);
     };
 
 }
\ No newline at end of file
@@ -35,7 +35,7 @@ namespace cxxspec {
         i(); stream << "{" << endl;
         chi(1);
             i(); stream << "\"type\": \"spec\"," << endl;
-            i(); stream << "\"desc\": \"" << spec.desc() << "\"," << endl;
+            i(); stream << "\"desc\": "; util::write_json_string(stream, spec.desc()); stream << "," << endl;
             i(); stream << "\"body\": [" << endl;
             chi(1);
     }
@@ -50,15 +50,22 @@ namespace cxxspec {
         i(); stream << "{" << endl;
         chi(1);
             i(); stream << "\"type\": \"example\"," << endl;
-            i(); stream << "\"name\": \"" << example.name() << "\"," << endl;
+            i(); stream << "\"name\": "; util::write_json_string(stream, example.name()); stream << "," << endl;
     }
 
     void JsonFormatter::onExampleResult(Example& example, bool result, std::string reason, ExampleDuration timeTaken) {
             i(); stream << "\"result\": " << (result ? "\"success\"" : "\"failed\"") << "," << endl;
-            i(); stream << "\"reason\": \"" << reason << "\"," << endl;
+            // reasons may span multiple lines (i.e. aggregated failures) or quote values
+            i(); stream << "\"reason\": "; util::write_json_string(stream, reason); stream << "," << endl;
             i(); stream << "\"time_ns\": " << timeTaken.count() << endl;
     }
 
+    void JsonFormatter::onExampleSkipped(Example& example, std::string reason) {
+            i(); stream << "\"result\": \"skipped\"," << endl;
+            i(); stream << "\"reason\": "; util::write_json_string(stream, reason); stream << "," << endl;
+            i(); stream << "\"time_ns\": 0" << endl;
+    }
+
     void JsonFormatter::onLeaveExample(Example& example, bool hasNextElement) {
         chi(-1);
         i(); stream << "}" << (hasNextElement ? "," : "") << endl;
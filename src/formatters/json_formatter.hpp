@@ -38,5 +38,6 @@ namespace cxxspec {
         void onEnterExample(Example& example);
         void onExampleResult(Example& example, bool result, std::string reason, ExampleDuration timeTaken);
         void onLeaveExample(Example& example, bool hasNextElement);
+        void onExampleSkipped(Example& example, std::string reason);
     };
 }
\ No newline at end of file
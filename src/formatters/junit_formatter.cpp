@@ -61,7 +61,7 @@ namespace cxxspec {
         stream << "<testsuite";
             stream << " errors=\"0\"";
             stream << " failures=\"" << this->failures << "\"";
-            stream << " skipped=\"0\"";
+            stream << " skipped=\"" << this->skipped << "\"";
             stream << " tests=\"" << this->testcases.size() << "\"";
             JunitDuration time = std::chrono::duration_cast<JunitDuration>(this->timeSum);
             stream << " time=\"" << time.count() << "\"";
@@ -74,7 +74,14 @@ namespace cxxspec {
                 stream << " classname=\"" << classname << "\"";
                 stream << " name=\"" << escapeString(testcase.name) << "\"";
                 stream << " time=\"" << testcase.timeTaken.count() << "\"";
-            if (testcase.result) {
+            if (testcase.skipped) {
+                stream << ">" << endl;
+                chi(1);
+                    i(); stream << "<skipped message=\"" << escapeString(testcase.reason) << "\"/>" << endl;
+                chi(-1);
+                i(); stream << "</testcase>" << endl;
+            }
+            else if (testcase.result) {
                 stream << "/>" << endl;
             }
             else {
@@ -114,5 +121,9 @@ namespace cxxspec {
         }
     }
     void JunitFormatter::onLeaveExample(Example& example, bool hasNextElement) {}
+    void JunitFormatter::onExampleSkipped(Example& example, std::string reason) {
+        testcases.push_back(JunitTestcase(example.fullname(), example.sourcefile(), false, reason, JunitDuration::zero(), true));
+        skipped++;
+    }
 
 }
\ No newline at end of file
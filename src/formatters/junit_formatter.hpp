@@ -32,12 +32,13 @@ namespace cxxspec {
         std::string sourcefile;
         JunitDuration timeTaken;
         bool result;
+        bool skipped;
         std::string reason;
 
         friend class JunitFormatter;
     public:
-        JunitTestcase(std::string name, std::string sourcefile, bool result, std::string reason, JunitDuration timeTaken)
-            : name(name), sourcefile(sourcefile), result(result), reason(reason), timeTaken(timeTaken)
+        JunitTestcase(std::string name, std::string sourcefile, bool result, std::string reason, JunitDuration timeTaken, bool skipped = false)
+            : name(name), sourcefile(sourcefile), result(result), reason(reason), timeTaken(timeTaken), skipped(skipped)
         {}
     };
 
@@ -46,6 +47,7 @@ namespace cxxspec {
         std::vector<JunitTestcase> testcases;
         ExampleDuration timeSum;
         std::size_t failures = 0;
+        std::size_t skipped = 0;
 
     public:
         JunitFormatter(std::ostream& stream, bool pretty = true) : PrettyableFormatter(stream, pretty) {}
@@ -59,5 +61,6 @@ namespace cxxspec {
         void onEnterExample(Example& example);
         void onExampleResult(Example& example, bool result, std::string reason, ExampleDuration timeTaken);
         void onLeaveExample(Example& example, bool hasNextElement);
+        void onExampleSkipped(Example& example, std::string reason);
     };
 }
\ No newline at end of file
@@ -0,0 +1,193 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "./contain.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && defined(__SSE2__)
+    #define CXXSPEC_SEARCH_SSE2 1
+    #include <immintrin.h>
+#endif
+
+namespace cxxspec {
+    namespace matchers {
+
+        /**
+         * Shared state of a search: the input & how much work verifying candidates took so far. A haystack full of
+         * candidates that don't match (i.e. "aaa...a" for "aa...ab") would make verifying them quadratic, so once that
+         * work exceeds the length of the haystack the remainder is searched with KMP instead.
+         */
+        struct Search {
+            const char* haystack;
+            std::size_t length;
+            const char* needle;
+            std::size_t needleLength;
+            std::size_t verified = 0;
+
+            Search(const char* haystack, std::size_t length, const char* needle, std::size_t needleLength)
+                : haystack(haystack), length(length), needle(needle), needleLength(needleLength)
+            {}
+
+            // whether the candidate at pos (whose first & last character already match) is a match
+            bool verify(std::size_t pos) {
+                this->verified += this->needleLength;
+                return std::memcmp(this->haystack + pos + 1, this->needle + 1, this->needleLength - 2) == 0;
+            }
+
+            bool exhausted() const {
+                return this->verified > this->length;
+            }
+
+            /**
+             * Knuth-Morris-Pratt from `pos` on; linear, but needs a table as large as the needle
+             */
+            std::size_t kmp(std::size_t pos) const {
+                std::vector<std::size_t> fail(this->needleLength, 0);
+                for (std::size_t i = 1, k = 0; i < this->needleLength; i++) {
+                    while (k > 0 && this->needle[i] != this->needle[k]) {
+                        k = fail[k - 1];
+                    }
+                    if (this->needle[i] == this->needle[k]) {
+                        k++;
+                    }
+                    fail[i] = k;
+                }
+
+                for (std::size_t i = pos, k = 0; i < this->length; i++) {
+                    while (k > 0 && this->haystack[i] != this->needle[k]) {
+                        k = fail[k - 1];
+                    }
+                    if (this->haystack[i] == this->needle[k]) {
+                        k++;
+                    }
+                    if (k == this->needleLength) {
+                        return i + 1 - this->needleLength;
+                    }
+                }
+                return std::string::npos;
+            }
+
+            /**
+             * Checks every position from `pos` on, jumping to the first character of the needle via memchr
+             */
+            std::size_t scalar(std::size_t pos) {
+                const char last = this->needle[this->needleLength - 1];
+                const std::size_t end = this->length - this->needleLength + 1;
+                while (pos < end) {
+                    const void* first = std::memchr(this->haystack + pos, static_cast<unsigned char>(this->needle[0]), end - pos);
+                    if (first == nullptr) {
+                        return std::string::npos;
+                    }
+                    pos = static_cast<const char*>(first) - this->haystack;
+                    if (this->haystack[pos + this->needleLength - 1] == last && this->verify(pos)) {
+                        return pos;
+                    }
+                    pos++;
+                    if (this->exhausted()) {
+                        return this->kmp(pos);
+                    }
+                }
+                return std::string::npos;
+            }
+
+            #if defined(CXXSPEC_SEARCH_SSE2)
+                /**
+                 * Verifies the candidates in `mask` (bit i = position `pos + i`)
+                 *
+                 * @return true if the search is decided: `found` is then the match, or the result of continuing with KMP
+                 */
+                bool candidates(std::size_t pos, unsigned mask, std::size_t& found) {
+                    while (mask != 0) {
+                        std::size_t candidate = pos + __builtin_ctz(mask);
+                        if (this->verify(candidate)) {
+                            found = candidate;
+                            return true;
+                        }
+                        if (this->exhausted()) {
+                            found = this->kmp(candidate + 1);
+                            return true;
+                        }
+                        mask &= mask - 1;
+                    }
+                    return false;
+                }
+
+                // compares the first & last character of the needle against 16 positions at once
+                std::size_t sse2() {
+                    const __m128i first = _mm_set1_epi8(this->needle[0]);
+                    const __m128i last = _mm_set1_epi8(this->needle[this->needleLength - 1]);
+
+                    std::size_t pos = 0;
+                    for (; pos + this->needleLength - 1 + 16 <= this->length; pos += 16) {
+                        __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(this->haystack + pos));
+                        __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(this->haystack + pos + this->needleLength - 1));
+                        unsigned mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last)));
+
+                        std::size_t found;
+                        if (mask != 0 && this->candidates(pos, mask, found)) {
+                            return found;
+                        }
+                    }
+                    return this->scalar(pos);
+                }
+
+                // the same with 32 positions at once; only called if the cpu supports AVX2
+                __attribute__((target("avx2")))
+                std::size_t avx2() {
+                    const __m256i first = _mm256_set1_epi8(this->needle[0]);
+                    const __m256i last = _mm256_set1_epi8(this->needle[this->needleLength - 1]);
+
+                    std::size_t pos = 0;
+                    for (; pos + this->needleLength - 1 + 32 <= this->length; pos += 32) {
+                        __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(this->haystack + pos));
+                        __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(this->haystack + pos + this->needleLength - 1));
+                        unsigned mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first), _mm256_cmpeq_epi8(blockLast, last)));
+
+                        std::size_t found;
+                        if (mask != 0 && this->candidates(pos, mask, found)) {
+                            return found;
+                        }
+                    }
+                    return this->scalar(pos);
+                }
+            #endif
+        };
+
+        std::size_t findSubstring(const char* haystack, std::size_t length, const char* needle, std::size_t needleLength) {
+            if (needleLength == 0) {
+                return 0;
+            }
+            if (needleLength > length) {
+                return std::string::npos;
+            }
+            if (needleLength == 1) {
+                const void* found = std::memchr(haystack, static_cast<unsigned char>(needle[0]), length);
+                return found == nullptr ? std::string::npos : static_cast<const char*>(found) - haystack;
+            }
+
+            Search search(haystack, length, needle, needleLength);
+            #if defined(CXXSPEC_SEARCH_SSE2)
+                static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+                return hasAvx2 ? search.avx2() : search.sse2();
+            #else
+                return search.scalar(0);
+            #endif
+        }
+
+    }
+}
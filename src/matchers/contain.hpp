@@ -28,12 +28,62 @@
 #include <algorithm>
 #include <map>
 #include <unordered_map>
+#include <cstring>
 
 #include <iostream>
 
+#if __cplusplus >= 201703L
+    #include <string_view>
+#endif
+
 namespace cxxspec {
     namespace matchers {
 
+        /**
+         * Position of the first occurrence of `needle` in `haystack`, or `std::string::npos`; takes time linear in the length
+         * of both. Candidates are located 32 (AVX2) or 16 (SSE2) bytes at a time where the cpu supports it.
+         */
+        std::size_t findSubstring(const char* haystack, std::size_t length, const char* needle, std::size_t needleLength);
+
+        namespace contain_impl {
+            // characters of a string, string_view or c-string
+            struct StringRef {
+                const char* data;
+                std::size_t size;
+            };
+
+            inline StringRef toStringRef(const char* str) {
+                return StringRef{ str, std::strlen(str) };
+            }
+
+            inline StringRef toStringRef(const std::string& str) {
+                return StringRef{ str.data(), str.size() };
+            }
+
+            template<class T>
+            struct is_stringish : util::is_c_str<T> {};
+
+            template<>
+            struct is_stringish<std::string> : std::true_type {};
+
+            #if __cplusplus >= 201703L
+                inline StringRef toStringRef(std::string_view str) {
+                    return StringRef{ str.data(), str.size() };
+                }
+
+                template<>
+                struct is_stringish<std::string_view> : std::true_type {};
+            #endif
+
+            // strings are searched for single characters & substrings through their characters
+            template<class T_got, class T_expected>
+            struct is_string_search : std::integral_constant<
+                bool,
+                is_stringish<T_got>::value
+                    && (std::is_same<char, typename std::decay<T_expected>::type>::value || is_stringish<typename std::decay<T_expected>::type>::value)
+            > {};
+        }
+
         template<typename T_got, typename T_expected = T_got>
         class IncludeMatcher : public ValueMatcher<T_got, T_expected> {
         protected:
@@ -41,6 +91,7 @@ namespace cxxspec {
             typedef std::integral_constant<int, 1> carray_type;
             typedef std::integral_constant<int, 2> cstring_type;
             typedef std::integral_constant<int, 3> iterator_type;
+            typedef std::integral_constant<int, 4> string_type;
 
             struct check_type : std::conditional<
                 util::is_mappish<T_got>::value,
@@ -48,7 +99,11 @@ namespace cxxspec {
                 typename std::conditional<
                     util::is_bounded_array<T_got>::value,
                     carray_type,
-                    typename std::conditional<util::is_c_str<T_got>::value, cstring_type, iterator_type>::type
+                    typename std::conditional<
+                        contain_impl::is_string_search<T_got, T_expected>::value,
+                        string_type,
+                        typename std::conditional<util::is_c_str<T_got>::value, cstring_type, iterator_type>::type
+                    >::type
                 >::type
             >::type {};
 
@@ -84,8 +139,22 @@ namespace cxxspec {
                 return false;
             }
 
+            bool _match(const T_got& got, string_type) {
+                return this->_find(contain_impl::toStringRef(got), std::is_same<char, typename std::decay<T_expected>::type>{});
+            }
+
+            bool _find(contain_impl::StringRef haystack, std::true_type) {
+                return std::memchr(haystack.data, static_cast<unsigned char>(this->expected_value), haystack.size) != nullptr;
+            }
+
+            bool _find(contain_impl::StringRef haystack, std::false_type) {
+                contain_impl::StringRef needle = contain_impl::toStringRef(this->expected_value);
+                return findSubstring(haystack.data, haystack.size, needle.data, needle.size) != std::string::npos;
+            }
+
             bool _match(const T_got& got, cstring_type) {
-                for (int i = 0; i < strlen(got); i++) {
+                std::size_t length = std::strlen(got);
+                for (std::size_t i = 0; i < length; i++) {
                     if (got[i] == this->expected_value) {
                         return true;
                     }
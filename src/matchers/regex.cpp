@@ -0,0 +1,136 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "./regex.hpp"
+#include "./contain.hpp"
+
+#include <cctype>
+#include <unordered_map>
+
+namespace cxxspec {
+    namespace matchers {
+
+        CompiledRegex::CompiledRegex(const std::string& pattern, SyntaxFlags flags)
+            : pattern(pattern), flags(flags)
+        {
+            this->literal = this->parseLiteral(pattern, flags);
+            if (!this->literal) {
+                // compiled right away, so invalid patterns are reported by the constructor
+                this->regex();
+            }
+        }
+
+        std::shared_ptr<const CompiledRegex> CompiledRegex::get(const std::string& pattern, SyntaxFlags flags) {
+            // bounded, so specs building patterns on the fly can't grow it forever; patterns in use stay alive anyway.
+            // Never destroyed, as matchers may still run during static destruction.
+            static const std::size_t maxEntries = 1024;
+            static std::unordered_map<std::string, std::shared_ptr<const CompiledRegex>>* cache
+                = new std::unordered_map<std::string, std::shared_ptr<const CompiledRegex>>();
+            static std::mutex mutex;
+
+            std::string key = std::to_string(static_cast<unsigned>(flags)) + '/' + pattern;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                auto it = cache->find(key);
+                if (it != cache->end()) {
+                    return it->second;
+                }
+            }
+
+            // compiled outside of the lock, so threads using other patterns aren't held up; a race just compiles it twice
+            std::shared_ptr<const CompiledRegex> compiled = std::make_shared<const CompiledRegex>(pattern, flags);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (cache->size() >= maxEntries) {
+                cache->clear();
+            }
+            return cache->emplace(key, compiled).first->second;
+        }
+
+        bool CompiledRegex::parseLiteral(const std::string& pattern, SyntaxFlags flags) {
+            using namespace std::regex_constants;
+
+            // other grammars, icase & multiline change what the characters of the pattern mean
+            SyntaxFlags neutral = ECMAScript | nosubs | optimize | collate;
+            if ((flags & ~neutral) != SyntaxFlags()) {
+                return false;
+            }
+
+            static const char special[] = "^$\\.*+?()[]{}|";
+            bool anchoredBegin = false;
+            bool anchoredEnd = false;
+            std::string text;
+
+            std::size_t pos = 0;
+            if (!pattern.empty() && pattern[0] == '^') {
+                anchoredBegin = true;
+                pos++;
+            }
+            while (pos < pattern.size()) {
+                char c = pattern[pos];
+                if (c == '\\') {
+                    // escaped punctuation is literal, but `\d`, `\b`, `\1` & co. aren't
+                    if (pos + 1 >= pattern.size() || std::isalnum(static_cast<unsigned char>(pattern[pos + 1]))) {
+                        return false;
+                    }
+                    text += pattern[pos + 1];
+                    pos += 2;
+                }
+                else if (c == '$' && pos + 1 == pattern.size()) {
+                    anchoredEnd = true;
+                    pos++;
+                }
+                else if (c == '\0' || std::strchr(special, c) != nullptr) {
+                    return false;
+                }
+                else {
+                    text += c;
+                    pos++;
+                }
+            }
+
+            this->anchoredBegin = anchoredBegin;
+            this->anchoredEnd = anchoredEnd;
+            this->text = std::move(text);
+            return true;
+        }
+
+        bool CompiledRegex::searchLiteral(const char* begin, const char* end) const {
+            std::size_t size = end - begin;
+            if (size < this->text.size() || (this->anchoredBegin && this->anchoredEnd && size != this->text.size())) {
+                return false;
+            }
+            if (this->anchoredBegin) {
+                return std::equal(this->text.begin(), this->text.end(), begin);
+            }
+            if (this->anchoredEnd) {
+                return std::equal(this->text.begin(), this->text.end(), end - this->text.size());
+            }
+            return findSubstring(begin, size, this->text.data(), this->text.size()) != std::string::npos;
+        }
+
+        const std::regex& CompiledRegex::regex() const {
+            std::call_once(this->regexOnce, [this] () {
+                this->_regex = std::regex(this->pattern, this->flags);
+            });
+            return this->_regex;
+        }
+
+    }
+}
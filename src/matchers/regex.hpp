@@ -22,31 +22,130 @@
 #include "../core/util.hpp"
 #include "../core/pretty_print.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <regex>
+#include <string>
+#include <type_traits>
 
 namespace cxxspec {
     namespace matchers {
 
+        /**
+         * A pattern of `to_match`, compiled once per process and shared by all matchers using it (see `get()`).
+         * Patterns that are just a string literal (optionally anchored with `^` / `$`) are searched for directly,
+         * without ever building a `std::regex`, as long as no flags change their meaning.
+         */
+        class CompiledRegex {
+        public:
+            typedef std::regex_constants::syntax_option_type SyntaxFlags;
+            typedef std::regex_constants::match_flag_type MatchFlags;
+
+            /**
+             * @throws std::regex_error if the pattern is invalid
+             */
+            CompiledRegex(const std::string& pattern, SyntaxFlags flags);
+
+            /**
+             * The compiled pattern from the process-wide cache; compiled on first use. Safe to call from multiple threads.
+             *
+             * @throws std::regex_error if the pattern is invalid
+             */
+            static std::shared_ptr<const CompiledRegex> get(const std::string& pattern, SyntaxFlags flags);
+
+            bool isLiteral() const {
+                return this->literal;
+            }
+
+            bool search(const char* begin, const char* end, MatchFlags flags) const {
+                if (this->literal && flags == std::regex_constants::match_default) {
+                    return this->searchLiteral(begin, end);
+                }
+                return std::regex_search(begin, end, this->regex(), flags);
+            }
+
+            template<typename Iterator>
+            bool search(Iterator begin, Iterator end, MatchFlags flags) const {
+                if (this->literal && flags == std::regex_constants::match_default) {
+                    return this->searchLiteral(begin, end);
+                }
+                return std::regex_search(begin, end, this->regex(), flags);
+            }
+
+        private:
+            /**
+             * Parses the pattern as an anchored literal; false if it's anything else
+             */
+            bool parseLiteral(const std::string& pattern, SyntaxFlags flags);
+
+            bool searchLiteral(const char* begin, const char* end) const;
+
+            template<typename Iterator>
+            bool searchLiteral(Iterator begin, Iterator end) const {
+                if (this->anchoredBegin && this->anchoredEnd) {
+                    return std::equal(begin, end, this->text.begin(), this->text.end());
+                }
+                if (this->anchoredBegin) {
+                    return std::mismatch(this->text.begin(), this->text.end(), begin, end).first == this->text.end();
+                }
+                if (this->anchoredEnd) {
+                    // compared backwards from the end of the input
+                    auto rbegin = std::make_reverse_iterator(end);
+                    auto rend = std::make_reverse_iterator(begin);
+                    return std::mismatch(this->text.rbegin(), this->text.rend(), rbegin, rend).first == this->text.rend();
+                }
+                return this->text.empty() || std::search(begin, end, this->text.begin(), this->text.end()) != end;
+            }
+
+            /**
+             * The `std::regex`; built on first use for literals, as they only need it for non-default match flags
+             */
+            const std::regex& regex() const;
+
+            std::string pattern;
+            SyntaxFlags flags;
+            bool literal = false;
+            bool anchoredBegin = false;
+            bool anchoredEnd = false;
+            // the literal without anchors & escapes
+            std::string text;
+            mutable std::once_flag regexOnce;
+            mutable std::regex _regex;
+        };
+
         template<typename T_got>
         class RegexMatcher : public Matcher<T_got> {
         private:
             std::string& regex_str;
-            std::regex regex;
+            std::shared_ptr<const CompiledRegex> regex;
             std::regex_constants::match_flag_type match_flags;
             std::regex_constants::syntax_option_type regex_flags;
 
             bool _match(const T_got& got, std::true_type) {
-                return std::regex_search( got, this->regex, this->match_flags );
+                return this->regex->search(got, got + std::strlen(got), this->match_flags);
             }
             bool _match(const T_got& got, std::false_type) {
-                return std::regex_search( got.begin(), got.end(), this->regex, this->match_flags );
+                return this->_search(got, 0);
+            }
+
+            // strings, string_views & co. are searched through their contiguous data
+            template<typename X = T_got>
+            auto _search(const X& got, int) -> decltype(static_cast<const char*>(got.data()), bool()) {
+                return this->regex->search(got.data(), got.data() + got.size(), this->match_flags);
+            }
+            template<typename X = T_got>
+            bool _search(const X& got, long) {
+                return this->regex->search(got.begin(), got.end(), this->match_flags);
             }
 
         public:
             RegexMatcher(std::string& regex_str)
                 : regex_str(regex_str), match_flags(std::regex_constants::match_default), regex_flags(std::regex_constants::ECMAScript)
             {
-                regex = std::regex(regex_str);
+                regex = CompiledRegex::get(regex_str, regex_flags);
             }
 
             RegexMatcher(std::string& regex_str,
@@ -55,7 +154,7 @@ namespace cxxspec {
             )
                 : regex_str(regex_str), match_flags(match_flags), regex_flags(regex_flags)
             {
-                regex = std::regex(regex_str, regex_flags);
+                regex = CompiledRegex::get(regex_str, regex_flags);
             }
 
             RegexMatcher(std::string& regex_str,
@@ -64,7 +163,7 @@ namespace cxxspec {
             )
                 : regex_str(regex_str), match_flags(match_flags), regex_flags(regex_flags)
             {
-                regex = std::regex(regex_str, regex_flags);
+                regex = CompiledRegex::get(regex_str, regex_flags);
             }
 
             bool match(const T_got& got) {
@@ -0,0 +1,237 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cxxspec.hpp"
+#include "./synthetic.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace cxxspec {
+namespace bench {
+
+    volatile std::size_t hookCalls = 0;
+
+    struct Options {
+        TreeShape shape;
+        // number of sourcefiles the describes are spread over
+        std::size_t files = 1;
+        std::string include = "cxxspec/cxxspec.hpp";
+        std::string outputDir;
+        bool run = false;
+        std::vector<std::string> runArguments;
+    };
+
+    static void indent(std::ostream& stream, unsigned level) {
+        for (unsigned i = 0; i < level; i++) {
+            stream << "    ";
+        }
+    }
+
+    // mirrors `defineLevel`
+    static void writeLevel(std::ostream& stream, const TreeShape& shape, unsigned level, std::size_t index) {
+        unsigned in = level + 1;
+        for (unsigned i = 0; i < shape.specHooks; i++) {
+            indent(stream, in); stream << "before_all(hookCalls = hookCalls + 1;)\n";
+            indent(stream, in); stream << "after_all(hookCalls = hookCalls + 1;)\n";
+        }
+        for (unsigned i = 0; i < shape.hooks; i++) {
+            indent(stream, in); stream << "before_each(hookCalls = hookCalls + 1;)\n";
+            indent(stream, in); stream << "after_each(hookCalls = hookCalls + 1;)\n";
+        }
+
+        if (level < shape.depth) {
+            for (unsigned i = 0; i < shape.fanout; i++) {
+                indent(stream, in); stream << "explain(\"context " << i << "\", $ {\n";
+                writeLevel(stream, shape, level + 1, index * shape.fanout + i);
+                indent(stream, in); stream << "});\n";
+            }
+            return;
+        }
+
+        std::size_t first = shape.firstExampleOfLeaf(index);
+        std::size_t count = shape.examplesInLeaf(index);
+        for (std::size_t i = first; i < first + count; i++) {
+            bool fail = shape.failEvery > 0 && i % shape.failEvery == 0;
+            indent(stream, in); stream << "it(\"example " << i << "\", _ {\n";
+            for (unsigned e = 0; e < shape.expects; e++) {
+                unsigned expected = fail && e + 1 == shape.expects ? e + 1 : e;
+                indent(stream, in + 1); stream << "expect(" << e << "u).to_eq(" << expected << "u);\n";
+            }
+            indent(stream, in); stream << "});\n";
+        }
+    }
+
+    static std::ofstream openSource(const std::string& path) {
+        std::ofstream stream(path);
+        if (!stream) {
+            throw std::runtime_error("Could not write " + path);
+        }
+        return stream;
+    }
+
+    static void writeSources(const Options& options) {
+        const TreeShape& shape = options.shape;
+        std::size_t files = std::min(options.files, shape.describes);
+
+        {
+            std::ofstream main = openSource(options.outputDir + "/main.cpp");
+            main << "// generated by specgen\n";
+            main << "#include <" << options.include << ">\n\n";
+            main << "volatile std::size_t hookCalls = 0;\n\n";
+            main << "CXXSPEC_MAIN\n";
+        }
+
+        // contiguous runs of describes per file, so every file is about the same size
+        for (std::size_t file = 0; file < files; file++) {
+            std::size_t first = shape.describes * file / files;
+            std::size_t last = shape.describes * (file + 1) / files;
+
+            std::ofstream stream = openSource(options.outputDir + "/specs_" + std::to_string(file) + ".cpp");
+            stream << "// generated by specgen\n";
+            stream << "#include <" << options.include << ">\n\n";
+            stream << "extern volatile std::size_t hookCalls;\n";
+            for (std::size_t i = first; i < last; i++) {
+                stream << "\ndescribe(describe_" << i << ", $ {\n";
+                writeLevel(stream, shape, 0, i);
+                stream << "});\n";
+            }
+        }
+    }
+
+    static std::size_t parseCount(const std::string& option, const std::string& value, bool allowZero) {
+        std::size_t end = 0;
+        unsigned long long count = 0;
+        try { count = std::stoull(value, &end); } catch (std::logic_error&) {}
+        if (end != value.size() || (count == 0 && !allowZero)) {
+            throw std::runtime_error("Invalid value for " + option + ": " + value);
+        }
+        return count;
+    }
+
+    static Options parseOptions(int argc, char** argv) {
+        Options options;
+        for (int i = 0; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "-h" || arg == "--help") {
+                puts("Usage: specgen [<options>] -o <dir>");
+                puts("       specgen [<options>] --run [-- <spec options>]");
+                puts("Generates a synthetic spec tree: either as sources (main.cpp & specs_<n>.cpp) written to <dir>,");
+                puts("or built at runtime and run with the usual options of a spec binary.");
+                puts("Available options:");
+                puts("  -o <dir>            Writes the sources into <dir>, which must exist");
+                puts("  --run               Builds the same tree at runtime and runs it; all arguments after '--'");
+                puts("                      are passed on, i.e. '-- --jobs auto' or '-- --list'");
+                puts("  --describes <n>     Top-level specs (default: 1)");
+                puts("  --examples <n>      Examples in total, spread evenly over the innermost contexts (default: 1000)");
+                puts("  --depth <n>         Levels of contexts below every describe (default: 2)");
+                puts("  --fanout <n>        Contexts inside every context (default: 4)");
+                puts("  --hooks <n>         before_each & after_each hooks per spec (default: 0)");
+                puts("  --spec-hooks <n>    before_all & after_all hooks per spec (default: 0)");
+                puts("  --expects <n>       Expectations per example (default: 1)");
+                puts("  --fail-every <n>    Every n-th example fails (default: none)");
+                puts("  --files <n>         Sourcefiles the describes are spread over (default: 1)");
+                puts("  --include <header>  Header included by the sources (default: cxxspec/cxxspec.hpp)");
+                exit(1);
+            }
+            if (arg == "--run") {
+                options.run = true;
+                continue;
+            }
+            if (arg == "--") {
+                for (i++; i < argc; i++) {
+                    options.runArguments.push_back(argv[i]);
+                }
+                break;
+            }
+            if (i + 1 >= argc) {
+                throw std::runtime_error("Unknown option or missing value: " + arg);
+            }
+            std::string value = argv[++i];
+            if (arg == "-o") {
+                options.outputDir = value;
+            }
+            else if (arg == "--describes") {
+                options.shape.describes = parseCount(arg, value, false);
+            }
+            else if (arg == "--examples") {
+                options.shape.examples = parseCount(arg, value, true);
+            }
+            else if (arg == "--depth") {
+                options.shape.depth = parseCount(arg, value, true);
+            }
+            else if (arg == "--fanout") {
+                options.shape.fanout = parseCount(arg, value, false);
+            }
+            else if (arg == "--hooks") {
+                options.shape.hooks = parseCount(arg, value, true);
+            }
+            else if (arg == "--spec-hooks") {
+                options.shape.specHooks = parseCount(arg, value, true);
+            }
+            else if (arg == "--expects") {
+                options.shape.expects = parseCount(arg, value, true);
+            }
+            else if (arg == "--fail-every") {
+                options.shape.failEvery = parseCount(arg, value, true);
+            }
+            else if (arg == "--files") {
+                options.files = parseCount(arg, value, false);
+            }
+            else if (arg == "--include") {
+                options.include = value;
+            }
+            else {
+                throw std::runtime_error("Unknown option: " + arg);
+            }
+        }
+
+        if (options.run != options.outputDir.empty()) {
+            throw std::runtime_error("Either -o <dir> or --run is needed (see --help)");
+        }
+        return options;
+    }
+
+}
+}
+
+int main(int argc, char** argv) {
+    using namespace cxxspec::bench;
+
+    try {
+        Options options = parseOptions(argc - 1, argv + 1);
+        if (options.run) {
+            // nothing is defined yet, so the top-level specs can still be moved
+            cxxspec::all_specs = buildTree(options.shape);
+            cxxspec::runSpecs(options.runArguments);
+        }
+        else {
+            writeSources(options);
+        }
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,126 @@
+/*
+ * cxxspec - a TDD/BDD framework for c++ projects
+ * Copyright (C) 2021-2024 Mai-Lapyst
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "cxxspec.hpp"
+
+#include <string>
+#include <vector>
+
+namespace cxxspec {
+namespace bench {
+
+    /**
+     * Shape of a synthetic spec tree: `describes` top-level specs, each with `depth` levels of `fanout` contexts below it.
+     * The examples are spread evenly over the innermost contexts (the leaves).
+     */
+    struct TreeShape {
+        std::size_t describes = 1;
+        std::size_t examples = 1000;
+        unsigned depth = 2;
+        unsigned fanout = 4;
+        // before_each & after_each hooks added to every spec
+        unsigned hooks = 0;
+        // before_all & after_all hooks added to every spec
+        unsigned specHooks = 0;
+        // `expect(...).to_eq(...)` per example
+        unsigned expects = 1;
+        // every n-th example fails it's last expectation; 0 for none
+        std::size_t failEvery = 0;
+
+        std::size_t leaves() const {
+            std::size_t count = this->describes;
+            for (unsigned i = 0; i < this->depth; i++) {
+                count *= this->fanout;
+            }
+            return count;
+        }
+
+        /**
+         * Number of examples in the leaf with the given index (counted over all describes)
+         */
+        std::size_t examplesInLeaf(std::size_t leaf) const {
+            std::size_t count = this->leaves();
+            return this->examples / count + (leaf < this->examples % count ? 1 : 0);
+        }
+
+        /**
+         * Index of the first example in the given leaf
+         */
+        std::size_t firstExampleOfLeaf(std::size_t leaf) const {
+            std::size_t count = this->leaves();
+            std::size_t rest = this->examples % count;
+            return leaf * (this->examples / count) + (leaf < rest ? leaf : rest);
+        }
+    };
+
+    // written by the hooks, so they can't be optimized away; defined by whoever builds trees
+    extern volatile std::size_t hookCalls;
+
+    inline void defineLevel(Spec& self, const TreeShape& shape, unsigned level, std::size_t index) {
+        for (unsigned i = 0; i < shape.specHooks; i++) {
+            self._add_spec_hook(Spec::HOOK_BEFORE, [] () { hookCalls = hookCalls + 1; });
+            self._add_spec_hook(Spec::HOOK_AFTER, [] () { hookCalls = hookCalls + 1; });
+        }
+        for (unsigned i = 0; i < shape.hooks; i++) {
+            self._add_example_hook(Spec::HOOK_BEFORE, [] (Example&) { hookCalls = hookCalls + 1; });
+            self._add_example_hook(Spec::HOOK_AFTER, [] (Example&) { hookCalls = hookCalls + 1; });
+        }
+
+        if (level < shape.depth) {
+            for (unsigned i = 0; i < shape.fanout; i++) {
+                std::size_t child = index * shape.fanout + i;
+                self._context("context " + std::to_string(i), [shape, level, child] (Spec& spec) {
+                    defineLevel(spec, shape, level + 1, child);
+                });
+            }
+            return;
+        }
+
+        std::size_t first = shape.firstExampleOfLeaf(index);
+        std::size_t count = shape.examplesInLeaf(index);
+        for (std::size_t i = first; i < first + count; i++) {
+            unsigned expects = shape.expects;
+            bool fail = shape.failEvery > 0 && i % shape.failEvery == 0;
+            self._it("example " + std::to_string(i), __FILE__, [expects, fail] (Example& self) {
+                for (unsigned e = 0; e < expects; e++) {
+                    expect(e).to_eq(fail && e + 1 == expects ? e + 1 : e);
+                }
+            });
+        }
+    }
+
+    /**
+     * Builds the top-level specs of a synthetic tree through the same API the DSL uses; the sources written by `specgen`
+     * define the same tree. Like with `describe`, everything below them is only defined once they are run or selected.
+     * The specs must not be moved afterwards, so they're returned in a vector that isn't supposed to grow.
+     */
+    inline std::vector<Spec> buildTree(const TreeShape& shape) {
+        std::vector<Spec> specs;
+        specs.reserve(shape.describes);
+        for (std::size_t i = 0; i < shape.describes; i++) {
+            specs.emplace_back("describe_" + std::to_string(i), [shape, i] (Spec& spec) {
+                defineLevel(spec, shape, 0, i);
+            });
+        }
+        return specs;
+    }
+
+}
+}
@@ -11,9 +11,56 @@ target("cxxspec")
     add_files("src/*.cpp", "src/**/*.cpp")
     add_headerfiles("src/*.hpp", "src/(**/*.hpp)", {prefixdir = "cxxspec"})
     add_includedirs("src", {public = true})
+    add_syslinks("pthread", {public = true})
+    add_syslinks("dl")
 
 target("specs")
     set_default(false)
     set_kind("binary")
     add_deps("cxxspec")
-    add_files("spec/*.cpp")
\ No newline at end of file
+    add_files("spec/*.cpp")
+
+-- the same specs compiled as c++20, which adds the asynchronous examples
+target("specs20")
+    set_default(false)
+    set_kind("binary")
+    set_languages("c++20")
+    add_deps("cxxspec")
+    add_files("spec/*.cpp")
+
+target("specs20-records")
+    set_default(false)
+    set_kind("binary")
+    set_languages("c++20")
+    add_deps("cxxspec")
+    add_files("spec/*.cpp")
+    add_defines("CXXSPEC_FAILURE_RECORDS")
+
+target("spec-module")
+    set_default(false)
+    set_kind("shared")
+    add_deps("cxxspec")
+    add_files("spec/*.cpp")
+
+target("cxxspec-run")
+    set_kind("binary")
+    add_deps("cxxspec")
+    add_files("runner/*.cpp")
+
+target("bench")
+    set_default(false)
+    set_kind("binary")
+    add_deps("cxxspec")
+    add_files("bench/*.cpp")
+
+target("bench-records")
+    set_default(false)
+    set_kind("binary")
+    add_deps("cxxspec")
+    add_files("bench/*.cpp")
+    add_defines("CXXSPEC_FAILURE_RECORDS")
+
+target("specgen")
+    set_kind("binary")
+    add_deps("cxxspec")
+    add_files("tools/specgen.cpp")